@@ -7,9 +7,28 @@
 #pragma once
 
 #include "VectorTests.h"
+#include "cvector_allocators.h"
+#include "cvector_execution.h"
+#include "cvector_pages.h"
+#include "small_cvector.h"
+#include "cvector_search_index.h"
+#include "frozen_cvector.h"
+#include "cvector_view.h"
+#include "cvector_span.h"
+#include "cvector_soa.h"
+#include "cvector_flat_map.h"
+#include "cvector_bits.h"
+#include "concurrent_cvector.h"
+#include "segmented_cvector.h"
 #include <string>
+#include <string_view>
 #include <format>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <source_location>
+#include <thread>
+#include <vector>
 
 
 // some flags to control console text attributes
@@ -28,6 +47,97 @@ const cvector<std::string> vABCD{ "a","b","c","d" };
 const cvector<std::string> vAtoH{ "a","b","c","d","e","f","g","h" };
 
 
+// a helper type which counts how many objects are alive right now
+struct LifetimeCounter
+{
+    static inline int numAlive = 0;
+
+    int val = 0;
+
+    LifetimeCounter()                             { ++numAlive; }
+    LifetimeCounter(const int v) : val(v)         { ++numAlive; }
+    LifetimeCounter(const LifetimeCounter& o) : val(o.val) { ++numAlive; }
+    ~LifetimeCounter()                            { --numAlive; }
+
+    LifetimeCounter& operator=(const LifetimeCounter& o) = default;
+};
+
+// a helper type which isn't trivially copyable but can be relocated with memcpy
+struct RelocHandle
+{
+    std::unique_ptr<int> ptr;
+
+    RelocHandle() = default;
+    RelocHandle(const int v) : ptr(std::make_unique<int>(v)) {}
+    RelocHandle(const RelocHandle& o) : ptr(o.ptr ? std::make_unique<int>(*o.ptr) : nullptr) {}
+    RelocHandle(RelocHandle&& o) noexcept = default;
+
+    RelocHandle& operator=(const RelocHandle& o) { ptr = o.ptr ? std::make_unique<int>(*o.ptr) : nullptr; return *this; }
+    RelocHandle& operator=(RelocHandle&& o) noexcept = default;
+
+    bool operator==(const RelocHandle& o) const { return ptr && o.ptr && (*ptr == *o.ptr); }
+};
+
+template<> struct is_trivially_relocatable<RelocHandle> : std::true_type {};
+
+// a big POD which takes a few cache lines
+struct BigPod
+{
+    int    id;
+    double payload[20];
+
+    bool operator==(const BigPod& o) const { return (id == o.id) && (payload[19] == o.payload[19]); }
+};
+
+// ----------------------------------------------------
+
+template <typename T, typename MakeValue>
+static bool CheckGatherByIdxs(MakeValue makeValue)
+{
+    // gather by idxs with runs of consecutive idxs, repeats and random jumps
+    // and compare to the plain indexed copy
+
+    cvector<T> src;
+    for (int i = 0; i < 600; ++i)
+        src.push_back(makeValue(i));
+
+    cvector<index> idxs;
+    for (index i = 0; i < 40; ++i)
+        idxs.push_back((i * 37) % 600);             // random jumps
+
+    for (index i = 100; i < 117; ++i)
+        idxs.push_back(i);                          // a short run
+
+    for (index i = 200; i < 500; ++i)
+        idxs.push_back(i);                          // a long run (a few gather blocks)
+
+    idxs.push_back(5);
+    idxs.push_back(5);                              // a repeat
+    idxs.push_back(6);
+
+    for (index i = 590; i < 600; ++i)
+        idxs.push_back(i);                          // a run at the end of src
+
+    for (index numIdxs = 0; numIdxs <= idxs.size(); ++numIdxs)
+    {
+        const cvector<index> someIdxs(idxs.begin(), idxs.begin() + numIdxs);
+        cvector<T> out;
+        src.get_data_by_idxs(someIdxs, out);
+
+        if (out.size() != numIdxs)
+            return false;
+
+        for (index i = 0; i < numIdxs; ++i)
+        {
+            if (!(out[i] == src[someIdxs[i]]))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
 void VectorTests::Run()
 {
     // test constructors
@@ -45,10 +155,16 @@ void VectorTests::Run()
     TestPushBack();
     TestPopBack();
     TestErase();
+    TestEraseIdxs();
+    TestEraseValues();
+    TestEraseIf();
     TestClear();
     TestReserve();
+    TestGrowthPolicy();
     TestResize();
     TestResizeWithVal();
+    TestResizeDefaultInit();
+    TestRawStorageLifetime();
 
     std::cout << std::endl;
 
@@ -64,9 +180,11 @@ void VectorTests::Run()
     TestShiftRight();
     TestShiftLeft();
     TestInsertBefore();
+    TestRelocatableType();
     TestGetInsertIdx();
     TestGetInsertIdxs();
     TestSortedInsertionMultiple();
+    TestInsertSorted();
     TestAppendCopyVector();
     TestAppendMoveVector();
 
@@ -74,11 +192,20 @@ void VectorTests::Run()
 
     PrintTestBlockHeader("TEST search/find/get:");
     TestFind();
+    TestFindSimd();
+    TestFindAny();
     TestGetIdx();
     TestGetIdxsFromRawArr();
     TestGetIdxsFromVector();
     TestGetDataByIdxs1();
     TestGetDataByIdxs2();
+    TestGatherByIdxs();
+    TestBranchlessSearch();
+    TestSearchIndex();
+    TestConstexprTable();
+    TestSpan();
+    TestSortedQueries();
+    TestExecutionPolicies();
 
     std::cout << std::endl;
 
@@ -88,13 +215,66 @@ void VectorTests::Run()
     TestBinarySearchForMultiple();
     TestBinarySearchForRawMultiple();
     TestBinarySearchForRawMultipleOutFlags();
+    TestBinarySearchPackedFlags();
+    TestPackedFlags();
 
     std::cout << std::endl;
 
     // test memory deallocation
     TestShrinkToFit();
     TestPurge();
-    
+    TestAllocTelemetry();
+
+    std::cout << std::endl;
+
+    PrintTestBlockHeader("TEST allocators:");
+    TestArenaAllocator();
+    TestPoolAllocator();
+    TestFrameAllocator();
+    TestPmrAllocator();
+    TestAlignedAllocator();
+    TestHugePageAllocator();
+    TestMremapAllocator();
+
+    std::cout << std::endl;
+
+    PrintTestBlockHeader("TEST small_cvector:");
+    TestSmallVectorInline();
+    TestSmallVectorSpill();
+    TestSmallVectorSearch();
+    TestSmallVectorCopyMove();
+
+    std::cout << std::endl;
+
+    PrintTestBlockHeader("TEST cvector_soa:");
+    TestSoaRowOps();
+    TestSoaColumns();
+
+    std::cout << std::endl;
+
+    PrintTestBlockHeader("TEST cvector_flat_map:");
+    TestFlatMapSingle();
+    TestFlatMapBulk();
+
+    std::cout << std::endl;
+
+    PrintTestBlockHeader("TEST concurrent_cvector:");
+    TestConcurrentPushBack();
+    TestConcurrentGrowBy();
+    TestConcurrentSegments();
+
+    std::cout << std::endl;
+
+    PrintTestBlockHeader("TEST segmented_cvector:");
+    TestSegmentedGrowth();
+    TestSegmentedSearch();
+
+    std::cout << std::endl;
+
+    PrintTestBlockHeader("TEST serialization:");
+    TestSaveLoad();
+    TestMappedView();
+
 
     printf("\n\n%sALL THE TEST ARE PASSED%s\n", KCYN, KNRM);
 }
@@ -323,6 +503,131 @@ void VectorTests::TestErase()
 
 ///////////////////////////////////////////////////////////
 
+void VectorTests::TestEraseIdxs()
+{
+    PrintTestName("Test erase_idxs(sortedIdxs):");
+
+    cvector<int>         vInt{ 0,1,2,3,4,5,6,7,8,9 };
+    cvector<std::string> vStr{ "a","b","c","d","e","f" };
+    cvector<RelocHandle> vHandles;
+
+    for (int i = 0; i < 10; ++i)
+        vHandles.push_back(RelocHandle(i));
+
+    // single idxs, runs of consecutive idxs and duplicates
+    const cvector<index> idxs{ 0, 2, 3, 4, 4, 8 };
+
+    Assert(vInt.erase_idxs(idxs) == 5, "test_1");
+    Assert(vHandles.erase_idxs(idxs) == 5, "test_2");
+    Assert(vStr.erase_idxs(idxs.data(), 5) == 4, "test_3");   // without 8
+
+    const int expected[] = { 1,5,6,7,9 };
+    const std::string expectedStr[] = { "b","f" };
+
+    Assert(std::equal(vInt.begin(), vInt.end(), std::begin(expected), std::end(expected)), "test_4");
+    Assert(std::equal(vStr.begin(), vStr.end(), std::begin(expectedStr), std::end(expectedStr)), "test_5");
+
+    for (index i = 0; i < vHandles.size(); ++i)
+        Assert(*vHandles[i].ptr == expected[i], "test_6");
+
+    // erase nothing / everything
+    Assert(vInt.erase_idxs(cvector<index>()) == 0, "test_7");
+    Assert(vInt.erase_idxs(cvector<index>{ 0,1,2,3,4 }) == 5, "test_8");
+    Assert(vInt.empty(), "test_9");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestEraseValues()
+{
+    PrintTestName("Test erase_values(sortedValues):");
+
+    // sorted with duplicates
+    cvector<int>         vInt{ 1,1,2,3,3,3,5,8,8,13 };
+    cvector<std::string> vStr{ "a","b","b","c","d" };
+
+    // some of values don't exist, some are duplicated
+    Assert(vInt.erase_values(cvector<int>{ 0,1,3,3,4,8,20 }) == 7, "test_1");
+    Assert(vStr.erase_values(cvector<std::string>{ "b","d","e" }) == 3, "test_2");
+
+    const int expected[] = { 2,5,13 };
+    const std::string expectedStr[] = { "a","c" };
+
+    Assert(std::equal(vInt.begin(), vInt.end(), std::begin(expected), std::end(expected)), "test_3");
+    Assert(std::equal(vStr.begin(), vStr.end(), std::begin(expectedStr), std::end(expectedStr)), "test_4");
+
+    Assert(vInt.erase_values(cvector<int>{ 2,5,13 }) == 3, "test_5");
+    Assert(vInt.empty(), "test_6");
+    Assert(vInt.erase_values(cvector<int>{ 2 }) == 0, "test_7");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestEraseIf()
+{
+    // test the compaction (SIMD for 4/8-byte types, scalar for the rest)
+    // against std::remove_if for different sizes and predicates
+    PrintTestName("Test erase_if(pred):");
+
+    for (int numElems = 0; numElems < 50; ++numElems)
+    {
+        for (int divisor = 1; divisor < 5; ++divisor)
+        {
+            auto pred = [divisor](const auto& val) { return ((long long)val % divisor) == 0; };
+
+            cvector<int>       vInt;
+            cvector<long long> vInt64;
+            cvector<float>     vFloat;
+            cvector<short>     vShort;
+
+            for (int i = 0; i < numElems; ++i)
+            {
+                const int val = (i * 13) % 17;
+                vInt.push_back(val);
+                vInt64.push_back(val);
+                vFloat.push_back((float)val);
+                vShort.push_back((short)val);
+            }
+
+            cvector<int> expected(vInt);
+            expected.resize(std::remove_if(expected.begin(), expected.end(), pred) - expected.begin());
+
+            const vsize numErased = numElems - expected.size();
+
+            Assert(vInt.erase_if(pred)   == numErased, "test_1");
+            Assert(vInt64.erase_if(pred) == numErased, "test_2");
+            Assert(vFloat.erase_if(pred) == numErased, "test_3");
+            Assert(vShort.erase_if(pred) == numErased, "test_4");
+
+            Assert(std::equal(vInt.begin(),   vInt.end(),   expected.begin(), expected.end()), "test_5");
+            Assert(std::equal(vInt64.begin(), vInt64.end(), expected.begin(), expected.end()), "test_6");
+            Assert(std::equal(vFloat.begin(), vFloat.end(), expected.begin(), expected.end()), "test_7");
+            Assert(std::equal(vShort.begin(), vShort.end(), expected.begin(), expected.end()), "test_8");
+        }
+    }
+
+    // non-trivial type: erased elements are destroyed
+    LifetimeCounter::numAlive = 0;
+    {
+        cvector<LifetimeCounter> v;
+        for (int i = 0; i < 10; ++i)
+            v.push_back(LifetimeCounter(i));
+
+        Assert(v.erase_if([](const LifetimeCounter& c) { return c.val % 3 == 0; }) == 4, "test_9");
+        Assert((v.size() == 6) && (LifetimeCounter::numAlive == 6), "test_10");
+        Assert((v[0].val == 1) && (v[5].val == 8), "test_11");
+    }
+    Assert(LifetimeCounter::numAlive == 0, "test_12");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
 void VectorTests::TestClear()
 {
     PrintTestName("Test clear():");
@@ -362,6 +667,77 @@ void VectorTests::TestReserve()
 
 ///////////////////////////////////////////////////////////
 
+struct Vec3
+{
+    float x, y, z;
+};
+
+void VectorTests::TestGrowthPolicy()
+{
+    PrintTestName("Test growth policies:");
+
+    // default: x1.5 starting from 8 elements
+    cvector<int> v1;
+    v1.push_back(0);
+    Assert(v1.capacity() == 8, "test_1");
+    for (int i = 1; i < 9; ++i) v1.push_back(i);
+    Assert(v1.capacity() == 12, "test_2");
+
+    // integer geometric factor and initial capacity
+    cvector<int, std::allocator<int>, growth_geometric<2, 1, 4>> v2;
+    cvector<vsize> caps2;
+    for (int i = 0; i < 20; ++i)
+    {
+        v2.push_back(i);
+        if (caps2.empty() || (caps2[caps2.size() - 1] != v2.capacity()))
+            caps2.push_back(v2.capacity());
+    }
+    Assert(std::equal(caps2.begin(), caps2.end(), cvector<vsize>{ 4, 8, 16, 32 }.begin()), "test_3");
+
+    // fixed step: push_back adds one step, append adds as many steps as needed
+    cvector<int, std::allocator<int>, growth_fixed_step<5>> v3;
+    v3.push_back(0);
+    Assert(v3.capacity() == 5, "test_4");
+    for (int i = 1; i < 6; ++i) v3.push_back(i);
+    Assert(v3.capacity() == 10, "test_5");
+    v3.append_vector(cvector<int, std::allocator<int>, growth_fixed_step<5>>(12, 7));
+    Assert((v3.size() == 18) && (v3.capacity() == 20), "test_6");
+
+    // power-of-two buffer sizes in bytes (for any element size)
+    cvector<Vec3, std::allocator<Vec3>, growth_pow2<>> v4;
+    bool isPow2 = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        v4.push_back({ (float)i, 0, 0 });
+        const size_t bytes = v4.capacity() * sizeof(Vec3);
+        isPow2 &= (std::bit_floor(bytes) == bytes) || (std::bit_ceil(bytes) - bytes < sizeof(Vec3));
+    }
+    Assert(isPow2, "test_7");
+    Assert((v4.size() == 1000) && (v4[999].x == 999.0f), "test_8");
+
+    // malloc_allocator reports the real block size: capacity includes the slack
+    cvector<int, malloc_allocator<int>, growth_pow2<>> v5;
+    for (int i = 0; i < 1000; ++i)
+        v5.push_back(i);
+
+    bool isOk = true;
+    for (int i = 0; i < 1000; ++i)
+        isOk &= (v5[i] == i);
+
+    Assert(isOk && (v5.capacity() >= 1024), "test_9");
+
+    // compile-time policies
+    static_assert(growth_geometric<3, 2, 8>::grow(0, 1, 4) == 8);
+    static_assert(growth_geometric<3, 2, 8>::grow(8, 9, 4) == 12);
+    static_assert(growth_geometric<3, 2, 8>::grow(1, 2, 4) == 2);           // grows by 1 at least
+    static_assert(growth_pow2<>::grow(8, 9, 12) == 21);                     // 256 bytes / 12
+    static_assert(growth_fixed_step<16>::grow(16, 100, 4) == 112);
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
 void VectorTests::TestResize()
 {
     PrintTestName("Test resize(const vsize sz):");
@@ -425,6 +801,81 @@ void VectorTests::TestResizeWithVal()
 
 ///////////////////////////////////////////////////////////
 
+void VectorTests::TestResizeDefaultInit()
+{
+    PrintTestName("Test resize_default_init(const vsize sz):");
+
+    // case_1: test with POD-type (old elements must remain the same)
+    cvector<int> vDst1{ 1,2 };
+
+    vDst1.resize_default_init(6);
+    Assert(vDst1.size() == 6, "wrong size");
+    Assert((vDst1[0] == 1) && (vDst1[1] == 2), "wrong data");
+
+    // case_2: test with std::string (new elems are default-constructed)
+    const cvector<std::string> vSrc2{ "a", "b", "", "" };
+    cvector<std::string> vDst2{ "a", "b" };
+
+    vDst2.resize_default_init(4);
+    AssertVectorsEqual(vDst2, vSrc2);
+
+    // case_3: make it smaller
+    vDst2.resize_default_init(1);
+    AssertVectorsEqual(vDst2, { "a" });
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestRawStorageLifetime()
+{
+    // test that only elements of range [0, size) are alive
+    PrintTestName("Test raw storage: constructed elems only in [0, size):");
+
+    LifetimeCounter::numAlive = 0;
+
+    {
+        cvector<LifetimeCounter> v;
+
+        // reserve() mustn't construct any object
+        v.reserve(100);
+        Assert(LifetimeCounter::numAlive == 0, "test_1");
+
+        for (int i = 0; i < 10; ++i)
+            v.push_back(LifetimeCounter(i));
+        Assert(LifetimeCounter::numAlive == 10, "test_2");
+
+        // growth: old elems are destroyed after moving into a new buffer
+        v.reserve(1000);
+        Assert(LifetimeCounter::numAlive == 10, "test_3");
+
+        v.erase(0);
+        v.pop_back();
+        Assert(LifetimeCounter::numAlive == 8, "test_4");
+
+        v.insert_before(3, LifetimeCounter(100));
+        Assert(LifetimeCounter::numAlive == 9, "test_5");
+        Assert((v[3].val == 100) && (v[4].val == 4), "test_6");
+
+        v.resize(4);
+        Assert(LifetimeCounter::numAlive == 4, "test_7");
+
+        v.clear();
+        Assert((LifetimeCounter::numAlive == 0) && (v.capacity() == 1000), "test_8");
+
+        v.resize(5, LifetimeCounter(1));
+        Assert(LifetimeCounter::numAlive == 5, "test_9");
+    }
+
+    // all the elements must be destroyed together with the cvector
+    Assert(LifetimeCounter::numAlive == 0, "test_10");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
 void VectorTests::TestOperatorEqual()
 {
     PrintTestName("Test operator==(const cvector<T>&) const:");
@@ -549,11 +1000,7 @@ void VectorTests::TestShiftRight()
     cvector<std::string>       v2{ "a","b","c","d","e","f","g" };
 
     const cvector<int>         v1AfterShift{ 1,2,3,4,3,4,5,6,7,8 };
-#if DEBUG || _DEBUG
     const cvector<std::string> v2AfterShift{ "a","b","","","c","d","e" };
-#else
-    const cvector<std::string> v2AfterShift{ "a","b","c","d","c","d","e" };
-#endif
 
     if constexpr (printDbgVector)
         PrintVector(v1, "\nv1 before shift: ");
@@ -640,6 +1087,48 @@ void VectorTests::TestInsertBefore()
 
 ///////////////////////////////////////////////////////////
 
+void VectorTests::TestRelocatableType()
+{
+    // test growth/shift/insert/erase/append for a type which is
+    // opted-in as trivially relocatable (it's moved using memcpy/memmove)
+    PrintTestName("Test relocatable type (memmove path):");
+
+    cvector<RelocHandle> v;
+
+    for (int i = 0; i < 20; ++i)
+        v.push_back(RelocHandle(i));                 // several reallocations
+
+    for (int i = 0; i < 20; ++i)
+        Assert(*v[i].ptr == i, "test_1");
+
+    v.insert_before(0, RelocHandle(100));
+    v.insert_before(5, RelocHandle(200));
+    Assert((*v[0].ptr == 100) && (*v[5].ptr == 200) && (*v[6].ptr == 4), "test_2");
+
+    v.erase(0);
+    v.erase(4);
+    Assert((v.size() == 20) && (*v[0].ptr == 0) && (*v[4].ptr == 4), "test_3");
+
+    // vacated positions become empty (moved-from) handles
+    v.shift_right(18, 1);
+    Assert((v[18].ptr == nullptr) && (*v[19].ptr == 18), "test_4");
+
+    v.shift_left(0, 2);
+    Assert((*v[0].ptr == 2) && (v[19].ptr == nullptr), "test_5");
+
+    cvector<RelocHandle> vSrc;
+    vSrc.push_back(RelocHandle(50));
+    vSrc.push_back(RelocHandle(51));
+
+    v.append_vector(std::move(vSrc));
+    Assert((v.size() == 22) && (*v[20].ptr == 50) && (*v[21].ptr == 51), "test_6");
+    Assert(vSrc.empty(), "test_7");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
 void VectorTests::TestGetInsertIdx()
 {
     PrintTestName("Test get_insert_idx(const ptrdiff_t& value)");
@@ -721,6 +1210,75 @@ void VectorTests::TestSortedInsertionMultiple()
 
 ///////////////////////////////////////////////////////////
 
+void VectorTests::TestInsertSorted()
+{
+    // test single-pass batched sorted insertion against std::merge
+    // (old elements go before the equal new ones)
+    PrintTestName("Test insert_sorted(values) / insert_sorted(values, outIdxs):");
+
+    cvector<int> vInt({ 1, 3, 5, 7, 10 });
+    cvector<int> vIntsToInsert({ 0, 2, 4, 6, 8, 9, 11, 15 });
+
+    vInt.insert_sorted(vIntsToInsert);
+    AssertVectorsEqual(vInt, { 0,1,2,3,4,5,6,7,8,9,10,11,15 });
+
+    // inserting into empty and inserting nothing
+    cvector<int> vEmpty;
+    vEmpty.insert_sorted(vIntsToInsert);
+    vEmpty.insert_sorted(cvector<int>());
+    AssertVectorsEqual(vEmpty, vIntsToInsert);
+
+    // random data with duplicates (relocatable / non-relocatable types)
+    for (int numElems = 0; numElems < 40; numElems += 3)
+    {
+        for (int numValues = 1; numValues < 25; numValues += 4)
+        {
+            cvector<int>         vOld, vNew;
+            cvector<std::string> vOldStr, vNewStr;
+
+            for (int i = 0; i < numElems; ++i)
+                vOld.push_back((i * 7) % 23);
+
+            for (int i = 0; i < numValues; ++i)
+                vNew.push_back((i * 5) % 29);
+
+            std::sort(vOld.begin(), vOld.end());
+            std::sort(vNew.begin(), vNew.end());
+
+            for (const int val : vOld)
+                vOldStr.push_back(std::format("{:02}old", val));
+
+            for (const int val : vNew)
+                vNewStr.push_back(std::format("{:02}new", val));
+
+            cvector<int> expected(numElems + numValues);
+            std::merge(vOld.begin(), vOld.end(), vNew.begin(), vNew.end(), expected.begin());
+
+            cvector<std::string> expectedStr(numElems + numValues);
+            std::merge(vOldStr.begin(), vOldStr.end(), vNewStr.begin(), vNewStr.end(), expectedStr.begin());
+
+            cvector<index> idxs;
+            cvector<index> idxsStr;
+            vOld.insert_sorted(vNew.data(), vNew.size(), idxs);
+            vOldStr.insert_sorted(vNewStr, idxsStr);
+
+            Assert(std::equal(vOld.begin(), vOld.end(), expected.begin(), expected.end()), "test_1");
+            Assert(std::equal(vOldStr.begin(), vOldStr.end(), expectedStr.begin(), expectedStr.end()), "test_2");
+
+            for (index i = 0; i < numValues; ++i)
+            {
+                Assert(vOld[idxs[i]] == vNew[i], "test_3");
+                Assert(vOldStr[idxsStr[i]] == vNewStr[i], "test_4");
+                Assert((i == 0) || (idxs[i] > idxs[i - 1]), "test_5");
+            }
+        }
+    }
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
 void VectorTests::TestAppendCopyVector()
 {
     PrintTestName("Test append_vector(const cvector<T>&):");
@@ -802,6 +1360,85 @@ void VectorTests::TestFind()
 
 ///////////////////////////////////////////////////////////
 
+template <typename T>
+static bool CheckFindAllPositions(const vsize numElems)
+{
+    // put a needle at each position (body and tail of SIMD loop)
+    // and check if find() returns the same idx as a scalar search
+
+    cvector<T> v(numElems, T(1));
+
+    if (v.find(T(7)) != -1)
+        return false;
+
+    for (vsize i = 0; i < numElems; ++i)
+    {
+        v[i] = T(7);
+
+        if ((v.find(T(7)) != i) || !v.has_value(T(7)))
+            return false;
+
+        v[i] = T(1);
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestFindSimd()
+{
+    // test: vectorized find() for different types/sizes
+    PrintTestName("Test find(const T& value) const for arithmetic types:");
+
+    enum class EnumId : uint16_t { a = 1, b = 7 };
+
+    Assert(CheckFindAllPositions<int8_t>(133), "test_1");
+    Assert(CheckFindAllPositions<int16_t>(133), "test_2");
+    Assert(CheckFindAllPositions<int>(133), "test_3");
+    Assert(CheckFindAllPositions<int64_t>(133), "test_4");
+    Assert(CheckFindAllPositions<float>(133), "test_5");
+    Assert(CheckFindAllPositions<double>(133), "test_6");
+    Assert(CheckFindAllPositions<int>(3), "test_7");
+
+    const cvector<EnumId> vEnum(100, EnumId::a);
+    Assert((vEnum.find(EnumId::b) == -1) && (vEnum.find(EnumId::a) == 0), "test_8");
+
+    // -0.0f == 0.0f so we must compare floats as floats (not as bits)
+    const cvector<float> vFloat{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, -0.0f };
+    Assert(vFloat.find(0.0f) == 8, "test_9");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestFindAny()
+{
+    // test: find first element which is equal to any of input values
+    PrintTestName("Test find_any(const T* values, const vsize n) const:");
+
+    cvector<int> vInt(100, 0);
+    vInt[40] = 5;
+    vInt[70] = 3;
+    vInt[90] = 9;
+
+    const int values1[2] = { 3, 9 };
+    const int values2[7] = { 100, 101, 102, 103, 104, 9, 5 };   // more than one pass
+    const int values3[2] = { 100, 101 };
+
+    Assert(vInt.find_any(values1, 2) == 70, "test_1");
+    Assert(vInt.find_any(values2, 7) == 40, "test_2");
+    Assert(vInt.find_any(values3, 2) == -1, "test_3");
+
+    const std::string strs[2] = { "x", "c" };
+    Assert(vAtoH.find_any(strs, 2) == 2, "test_4");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
 void VectorTests::TestGetIdx()
 {
     PrintTestName("Test get_idx(const T&) const:");
@@ -928,51 +1565,501 @@ void VectorTests::TestGetDataByIdxs2()
 
 ///////////////////////////////////////////////////////////
 
-void VectorTests::TestHasValue()
+void VectorTests::TestGatherByIdxs()
 {
-    PrintTestName("Test has_value(const T&) const:");
+    // test the gather engine: AVX2 gather for 4/8-byte elements,
+    // memcpy for runs of consecutive idxs, prefetching for big structs
+    PrintTestName("Test get_data_by_idxs() gather (runs/SIMD/prefetch):");
 
-    const cvector<int>         vInt(v1to10);
-    const cvector<std::string> vStr(vAtoH);
+    Assert(CheckGatherByIdxs<int>      ([](int i) { return i * 3; }), "test_1");
+    Assert(CheckGatherByIdxs<float>    ([](int i) { return (float)i * 0.5f; }), "test_2");
+    Assert(CheckGatherByIdxs<long long>([](int i) { return (long long)i << 33; }), "test_3");
+    Assert(CheckGatherByIdxs<double>   ([](int i) { return (double)i * 0.25; }), "test_4");
+    Assert(CheckGatherByIdxs<short>    ([](int i) { return (short)i; }), "test_5");
 
-    Assert(vInt.has_value(1)   == true, "test_1");
-    Assert(vInt.has_value(10)  == true, "test_2");
-    Assert(vInt.has_value(0)   == false, "test_3");
+    Assert(CheckGatherByIdxs<BigPod>([](int i)
+    {
+        BigPod pod{ i, {} };
+        pod.payload[19] = i * 2.0;
+        return pod;
+    }), "test_6");
 
-    Assert(vStr.has_value("a") == true, "test_4");
-    Assert(vStr.has_value("h") == true, "test_5");
-    Assert(vStr.has_value("x") == false, "test_6");
+    Assert(CheckGatherByIdxs<std::string>([](int i) { return std::to_string(i); }), "test_7");
 
     PrintPassed();
 }
 
 ///////////////////////////////////////////////////////////
 
-void VectorTests::TestBinarySearchForSingle()
+void VectorTests::TestBranchlessSearch()
 {
-    // test for a single value (int / std::string)
-    PrintTestName("Test binary_search(const T& val):");
-
-    const cvector<int>         vInt(v1to10);
-    const cvector<std::string> vStr{ "a","b","c","kek" };
-
-    Assert(vInt.binary_search(1)   == true, "test_1");
-    Assert(vInt.binary_search(10)  == true, "test_2");
-    Assert(vInt.binary_search(99)  == false, "test_3");
+    // test the sorted-lookup family (which uses branchless binary search for
+    // arithmetic types) against std algorithms for arrays of different sizes
+    PrintTestName("Test branchless search (get_idx/get_idxs/get_insert_idx):");
 
-    Assert(vStr.binary_search("a")   == true, "test_4");
-    Assert(vStr.binary_search("kek") == true, "test_5");
-    Assert(vStr.binary_search("lol") == false, "test_6");
+    for (int numElems = 0; numElems < 70; ++numElems)
+    {
+        // sorted array with duplicates: 0,0,2,2,4,4...
+        cvector<int> v;
+        for (int i = 0; i < numElems; ++i)
+            v.push_back((i / 2) * 2);
+
+        cvector<int> values;
+        for (int val = -1; val <= numElems + 1; ++val)
+            values.push_back(val);
+
+        cvector<index> idxs;
+        cvector<index> insertIdxs;
+        cvector<bool>  flags;
+
+        v.get_idxs(values, idxs);
+        v.get_insert_idxs(values, insertIdxs);
+        v.binary_search(values.data(), values.size(), flags);
+
+        for (index i = 0; i < values.size(); ++i)
+        {
+            const int  val   = values[i];
+            const auto lower = std::lower_bound(v.begin(), v.end(), val);
+            const auto upper = std::upper_bound(v.begin(), v.end(), val);
+
+            Assert(idxs[i]       == std::distance(v.begin(), lower), "test_1");
+            Assert(insertIdxs[i] == std::distance(v.begin(), upper), "test_2");
+            Assert(v.get_insert_idx(val) == insertIdxs[i], "test_3");
+            Assert(v.get_idx(val) == std::distance(v.begin(), upper) - 1, "test_4");
+            Assert(v.binary_search(val) == std::binary_search(v.begin(), v.end(), val), "test_5");
+        }
+
+        // flags are searched in [begin+i, end) (see binary_search())
+        const int* data = v.data();
+        const int* last = data + v.size();
+
+        for (index i = 0; i < values.size(); ++i)
+        {
+            const int* first = std::min(data + i, last);
+            Assert(flags[i] == std::binary_search(first, last, values[i]), "test_6");
+        }
+    }
 
     PrintPassed();
 }
 
 ///////////////////////////////////////////////////////////
 
-void VectorTests::TestBinarySearchForMultiple()
+void VectorTests::TestSearchIndex()
 {
-    // test for multiple values (multiple integers / std::strings)
-    PrintTestName("Test binary_seach(const cvector<T>& values) const:");
+    // test Eytzinger search index against std algorithms for arrays of different
+    // sizes (complete and incomplete trees), and its rebuild after changes
+    PrintTestName("Test cvector_search_index (lower_bound/upper_bound/get_idx/rebuild):");
+
+    for (int numElems = 0; numElems < 70; ++numElems)
+    {
+        // sorted array with duplicates: 0,0,2,2,4,4...
+        cvector<int> v;
+        for (int i = 0; i < numElems; ++i)
+            v.push_back((i / 2) * 2);
+
+        const cvector_search_index<int> searchIdx(v);
+
+        cvector<int> values;
+        for (int val = -1; val <= numElems + 1; ++val)
+            values.push_back(val);
+
+        cvector<index> idxs;
+        cvector<bool>  flags;
+        searchIdx.get_idxs(values.data(), values.size(), idxs);
+        searchIdx.binary_search(values.data(), values.size(), flags);
+
+        Assert(searchIdx.size() == v.size(), "test_1");
+
+        for (index i = 0; i < values.size(); ++i)
+        {
+            const int  val   = values[i];
+            const auto lower = std::distance(v.begin(), std::lower_bound(v.begin(), v.end(), val));
+            const auto upper = std::distance(v.begin(), std::upper_bound(v.begin(), v.end(), val));
+            const bool found = std::binary_search(v.begin(), v.end(), val);
+
+            Assert(searchIdx.lower_bound(val)   == lower,     "test_2");
+            Assert(searchIdx.upper_bound(val)   == upper,     "test_3");
+            Assert(searchIdx.get_idx(val)       == upper - 1, "test_4");
+            Assert(searchIdx.binary_search(val) == found,     "test_5");
+            Assert(idxs[i]                      == lower,     "test_6");
+            Assert(flags[i]                     == found,     "test_7");
+        }
+    }
+
+    // the index is a snapshot: rebuild it after the source is changed
+    cvector<std::string> vStr{ "b","d","f" };
+    cvector_search_index<std::string> strIdx(vStr);
+
+    Assert(strIdx.lower_bound("c") == 1, "test_8");
+
+    vStr.insert_before(0, "a");
+    Assert(strIdx.lower_bound("c") == 1, "test_9");
+
+    strIdx.rebuild(vStr);
+    Assert(strIdx.lower_bound("c") == 2, "test_10");
+    Assert(strIdx.binary_search("a") == true, "test_11");
+    Assert(strIdx.binary_search("c") == false, "test_12");
+
+    strIdx.rebuild(cvector<std::string>());
+    Assert(strIdx.empty() && (strIdx.lower_bound("a") == 0), "test_13");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+constexpr cvector<int> MakeMaterialIds()
+{
+    // build a sorted table at compile time
+    cvector<int> ids{ 40, 10, 30 };
+
+    for (int i = 0; i < 50; ++i)
+        ids.push_back(100 + (i * 37) % 50);
+
+    ids.push_back(20);
+    std::sort(ids.begin(), ids.end());
+
+    return ids;
+}
+
+constexpr bool CheckConstexprSearch()
+{
+    const cvector<int> ids = MakeMaterialIds();
+
+    return (ids.size() == 54) &&
+           ids.binary_search(30) && !ids.binary_search(35) &&
+           (ids.get_idx(30) == 2) && (ids.get_idx(35) == 2) && (ids.get_idx(5) == -1);
+}
+
+static_assert(CheckConstexprSearch());
+
+constexpr index GetConstexprStrIdx(const char* str)
+{
+    // non-trivial types work at compile time too
+    cvector<std::string> v{ "b", "d", "a" };
+    v.push_back("c");
+    std::sort(v.begin(), v.end());
+    return v.get_idx(str);
+}
+
+static_assert(GetConstexprStrIdx("c") == 2);
+
+static constexpr auto materialIds = cvector_freeze<MakeMaterialIds>();
+
+static_assert(materialIds.size() == 54);
+static_assert(materialIds.get_idx(40) == 3);
+
+void VectorTests::TestConstexprTable()
+{
+    PrintTestName("Test constexpr cvector and frozen table:");
+
+    const cvector<int> ids = MakeMaterialIds();     // the same table built at runtime
+
+    Assert(std::equal(ids.begin(), ids.end(), materialIds.begin(), materialIds.end()), "test_1");
+
+    // runtime queries to the frozen table give the same results as to cvector
+    bool isOk = true;
+    for (int value = 0; value < 160; ++value)
+    {
+        isOk &= (materialIds.get_idx(value)        == ids.get_idx(value));
+        isOk &= (materialIds.binary_search(value)  == ids.binary_search(value));
+        isOk &= (materialIds.find(value)           == ids.find(value));
+        isOk &= (materialIds.get_insert_idx(value) == ids.get_insert_idx(value));
+    }
+    Assert(isOk, "test_2");
+
+    // frozen table of names (std::string can't be stored in static storage
+    // at compile time, std::string_view can)
+    constexpr auto names = cvector_freeze<[]()
+    {
+        cvector<std::string_view> v{ "stone", "grass", "wood" };
+        v.push_back("metal");
+        std::sort(v.begin(), v.end());
+        return v;
+    }>();
+
+    Assert((names.size() == 4) && (names[0] == "grass"), "test_3");
+    Assert(names.binary_search("wood") && !names.binary_search("sand"), "test_4");
+    Assert(names.get_idx("stone") == 2, "test_5");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestSpan()
+{
+    PrintTestName("Test cvector_span (search in a subrange and in foreign containers):");
+
+    // sorted with duplicates: 0,0,2,2,4,4...
+    cvector<int> v;
+    for (int i = 0; i < 200; ++i)
+        v.push_back((i / 2) * 2);
+
+    const cvector_span<const int> all(v);
+    const cvector_span<const int> sub = all.subspan(50, 100);     // values [50, 150)
+
+    Assert((all.size() == v.size()) && (all.data() == v.data()), "test_1");
+    Assert((sub.size() == 100) && (sub[0] == 50) && (sub.last(1)[0] == 148), "test_2");
+
+    // single queries give the same results as cvector on the same elements
+    cvector<int> subVec;
+    for (const int value : sub)
+        subVec.push_back(value);
+
+    bool isOk = true;
+
+    for (int value = 40; value < 160; ++value)
+    {
+        isOk &= (sub.find(value)           == subVec.find(value));
+        isOk &= (sub.get_idx(value)        == subVec.get_idx(value));
+        isOk &= (sub.get_insert_idx(value) == subVec.get_insert_idx(value));
+        isOk &= (sub.binary_search(value)  == subVec.binary_search(value));
+    }
+    Assert(isOk, "test_3");
+
+    // batched queries into caller-provided outputs (no allocations)
+    const int values[] = { 49, 50, 51, 100, 101, 148, 150 };
+    index     idxs[7];
+    index     insIdxs[7];
+    bool      flags[7];
+
+    cvector<index> expIdxs, expInsIdxs;
+    cvector<bool>  expFlags;
+
+    sub.get_idxs(values, idxs);
+    sub.get_insert_idxs(values, insIdxs, query_order::sorted);
+    sub.binary_search(values, flags);
+
+    subVec.get_idxs(values, 7, expIdxs);
+    subVec.get_insert_idxs(values, 7, expInsIdxs);
+    subVec.binary_search(values, 7, expFlags);
+
+    Assert(std::equal(idxs, idxs + 7, expIdxs.begin()), "test_4");
+    Assert(std::equal(insIdxs, insIdxs + 7, expInsIdxs.begin()), "test_5");
+    Assert(std::equal(flags, flags + 7, expFlags.begin()), "test_6");
+
+    const int present[] = { 50, 52, 54 };
+    Assert(sub.binary_search(present) && !sub.binary_search(values), "test_7");
+    Assert(sub.find_any(values) == 0, "test_8");
+
+    // gather by indices into a span of std::vector
+    const index      gatherIdxs[] = { 99, 0, 10 };
+    std::vector<int> gathered(3);
+
+    sub.get_data_by_idxs(gatherIdxs, cvector_span<int>(gathered));
+    Assert((gathered[0] == 148) && (gathered[1] == 50) && (gathered[2] == 60), "test_9");
+
+    // spans of a frozen table and of a raw array
+    const cvector_span<const int> frozen(materialIds);
+    Assert(frozen.get_idx(40) == materialIds.get_idx(40), "test_10");
+
+    int arr[] = { 5, 3, 7 };
+    cvector_span<int> arrSpan(arr);
+    arrSpan[1] = 4;
+    Assert((arr[1] == 4) && (arrSpan.find(7) == 2) && !arrSpan.has_value(3), "test_11");
+
+    // mutable spans of non-const cvectors (output idxs into a cvector<index>)
+    cvector<index> outIdxs(7);
+    cvector_span<int> mutSpan(v);
+    mutSpan[0] = -1;
+
+    sub.get_idxs(values, cvector_span<index>(outIdxs));
+    Assert((v[0] == -1) && std::equal(outIdxs.begin(), outIdxs.end(), expIdxs.begin()), "test_12");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestSortedQueries()
+{
+    // test batched lookups with sorted queries (galloping search which resumes
+    // from the previous hit) against independent binary searches
+    PrintTestName("Test sorted queries (get_idxs/get_insert_idxs/binary_search + query_order):");
+
+    for (int numElems = 0; numElems < 300; numElems += 7)
+    {
+        // sorted array with duplicates: 0,0,0,3,3,3,6...
+        cvector<int> v;
+        for (int i = 0; i < numElems; ++i)
+            v.push_back((i / 3) * 3);
+
+        // sorted queries: dense at the beginning, sparse at the end, with repeats
+        cvector<int> values{ -5, -5 };
+        for (int val = -1; val <= numElems + 2; val += 1 + val / 16)
+        {
+            values.push_back(val);
+            if (val % 5 == 0)
+                values.push_back(val);
+        }
+
+        cvector<index> idxs1, idxs2, idxs3;
+        cvector<index> insIdxs1, insIdxs2;
+        cvector<bool>  flags1, flags2;
+
+        v.get_idxs(values, idxs1, query_order::unsorted);
+        v.get_idxs(values, idxs2, query_order::sorted);
+        v.get_idxs(values.data(), values.size(), idxs3);         // detected as sorted
+
+        v.get_insert_idxs(values, insIdxs1, query_order::unsorted);
+        v.get_insert_idxs(values.data(), values.size(), insIdxs2);
+
+        v.binary_search(values.data(), values.size(), flags1, query_order::unsorted);
+        v.binary_search(values.data(), values.size(), flags2, query_order::sorted);
+
+        for (index i = 0; i < values.size(); ++i)
+        {
+            const auto lower = std::lower_bound(v.begin(), v.end(), values[i]);
+            const auto upper = std::upper_bound(v.begin(), v.end(), values[i]);
+
+            Assert(idxs1[i] == std::distance(v.begin(), lower), "test_1");
+            Assert(idxs2[i] == idxs1[i], "test_2");
+            Assert(idxs3[i] == idxs1[i], "test_3");
+
+            Assert(insIdxs1[i] == std::distance(v.begin(), upper), "test_4");
+            Assert(insIdxs2[i] == insIdxs1[i], "test_5");
+
+            Assert(flags2[i] == flags1[i], "test_6");
+        }
+    }
+
+    // unsorted queries are detected and searched independently
+    const cvector<std::string> vStr{ "a","c","e","g" };
+    const cvector<std::string> queries{ "g","a","d","a" };
+    cvector<index> strIdxs;
+
+    vStr.get_idxs(queries, strIdxs);
+    AssertVectorsEqual(strIdxs, { 3,0,2,0 });
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestExecutionPolicies()
+{
+    // test batched methods with seq/par/par_unseq policies (on the default pool
+    // and on an explicit pool of 4 threads) against the sequential ones
+    PrintTestName("Test execution policies (seq/par/par_unseq) for batched methods:");
+
+    cvector_exec::thread_pool pool(4);
+
+    // thread pool: each chunk is executed exactly once
+    cvector<int> chunkCounters(1000, 0);
+    pool.parallel_for(chunkCounters.size(), [&](ptrdiff_t chunkIdx) { chunkCounters[chunkIdx]++; });
+    Assert(std::all_of(chunkCounters.begin(), chunkCounters.end(), [](int c) { return c == 1; }), "test_1");
+
+    // sorted array with duplicates
+    cvector<int> v;
+    for (int i = 0; i < 50000; ++i)
+        v.push_back((i / 2) * 3);
+
+    // unsorted and sorted queries (a few chunks)
+    cvector<int> queries;
+    for (int i = 0; i < 30000; ++i)
+        queries.push_back((i * 7919) % 80000 - 100);
+
+    cvector<int> sortedQueries(queries);
+    std::sort(sortedQueries.begin(), sortedQueries.end());
+
+    cvector<index> gatherIdxs;
+    for (index i = 0; i < 30000; ++i)
+        gatherIdxs.push_back((i < 10000) ? i : (i * 31) % v.size());
+
+    for (const cvector<int>* pQueries : { &queries, &sortedQueries })
+    {
+        const cvector<int>& q = *pQueries;
+
+        cvector<index> idxs, insIdxs, gathered0;
+        cvector<bool>  flags;
+        cvector<int>   gathered;
+
+        v.get_idxs(q, idxs);
+        v.get_insert_idxs(q, insIdxs);
+        v.binary_search(q.data(), q.size(), flags);
+        v.get_data_by_idxs(gatherIdxs, gathered);
+
+        auto check = [&](auto policy)
+        {
+            cvector<index> pIdxs, pInsIdxs;
+            cvector<bool>  pFlags;
+            cvector<int>   pGathered;
+
+            v.get_idxs(policy, q, pIdxs);
+            v.get_insert_idxs(policy, q.data(), q.size(), pInsIdxs);
+            v.binary_search(policy, q.data(), q.size(), pFlags);
+            v.get_data_by_idxs(policy, gatherIdxs, pGathered);
+
+            return std::equal(pIdxs.begin(),     pIdxs.end(),     idxs.begin(),     idxs.end()) &&
+                   std::equal(pInsIdxs.begin(),  pInsIdxs.end(),  insIdxs.begin(),  insIdxs.end()) &&
+                   std::equal(pFlags.begin(),    pFlags.end(),    flags.begin(),    flags.end()) &&
+                   std::equal(pGathered.begin(), pGathered.end(), gathered.begin(), gathered.end());
+        };
+
+        Assert(check(cvector_exec::seq),                 "test_2");
+        Assert(check(cvector_exec::par),                 "test_3");
+        Assert(check(cvector_exec::par_unseq),           "test_4");
+        Assert(check(cvector_exec::par.on(pool)),        "test_5");
+        Assert(check(cvector_exec::par_unseq.on(pool)),  "test_6");
+    }
+
+    // empty batch
+    cvector<index> emptyIdxs{ 1, 2 };
+    v.get_idxs(cvector_exec::par.on(pool), cvector<int>(), emptyIdxs);
+    Assert(emptyIdxs.empty(), "test_7");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestHasValue()
+{
+    PrintTestName("Test has_value(const T&) const:");
+
+    const cvector<int>         vInt(v1to10);
+    const cvector<std::string> vStr(vAtoH);
+
+    Assert(vInt.has_value(1)   == true, "test_1");
+    Assert(vInt.has_value(10)  == true, "test_2");
+    Assert(vInt.has_value(0)   == false, "test_3");
+
+    Assert(vStr.has_value("a") == true, "test_4");
+    Assert(vStr.has_value("h") == true, "test_5");
+    Assert(vStr.has_value("x") == false, "test_6");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestBinarySearchForSingle()
+{
+    // test for a single value (int / std::string)
+    PrintTestName("Test binary_search(const T& val):");
+
+    const cvector<int>         vInt(v1to10);
+    const cvector<std::string> vStr{ "a","b","c","kek" };
+
+    Assert(vInt.binary_search(1)   == true, "test_1");
+    Assert(vInt.binary_search(10)  == true, "test_2");
+    Assert(vInt.binary_search(99)  == false, "test_3");
+
+    Assert(vStr.binary_search("a")   == true, "test_4");
+    Assert(vStr.binary_search("kek") == true, "test_5");
+    Assert(vStr.binary_search("lol") == false, "test_6");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestBinarySearchForMultiple()
+{
+    // test for multiple values (multiple integers / std::strings)
+    PrintTestName("Test binary_seach(const cvector<T>& values) const:");
 
     cvector<int>         vInt(v1to10);
     cvector<std::string> vStr(vAtoH);
@@ -1051,6 +2138,100 @@ void VectorTests::TestBinarySearchForRawMultipleOutFlags()
     PrintPassed();
 }
 
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestBinarySearchPackedFlags()
+{
+    PrintTestName("Test binary_seach(const T* values, size numElems, cvector_bits& flags) const:");
+
+    cvector<int> v;
+    for (int i = 0; i < 1000; ++i)
+        v.push_back(i * 3);
+
+    // sorted and unsorted queries give the same flags as cvector<bool> output
+    cvector<int> queries;
+    for (int i = 0; i < 300; ++i)
+        queries.push_back(i * 5);
+
+    cvector<bool> expected;
+    cvector_bits  flags;
+
+    v.binary_search(queries.data(), queries.size(), expected);
+    v.binary_search(queries.data(), queries.size(), flags);
+
+    bool isOk = (flags.size() == expected.size());
+    for (index i = 0; i < expected.size(); ++i)
+        isOk &= (flags[i] == expected[i]);
+    Assert(isOk, "test_1");
+
+    // each 3rd query is a multiple of 15
+    Assert(flags.count() == 100, "test_2");
+
+    std::reverse(queries.begin(), queries.end());
+    v.binary_search(queries.data(), queries.size(), expected);
+    v.binary_search(queries.data(), queries.size(), flags, query_order::unsorted);
+
+    isOk = true;
+    for (index i = 0; i < expected.size(); ++i)
+        isOk &= (flags[i] == expected[i]);
+    Assert(isOk, "test_3");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestPackedFlags()
+{
+    PrintTestName("Test cvector_bits: count/find/bitwise ops/to_idxs:");
+
+    cvector_bits a(200);
+    cvector_bits b(200, true);
+
+    Assert((a.num_words() == 4) && a.none() && b.all() && (b.count() == 200), "test_1");
+
+    for (index i = 0; i < 200; i += 7)
+        a.set(i);
+
+    Assert((a.count() == 29) && a[63] && !a[64] && a[196], "test_2");
+    Assert((a.find_first_set() == 0) && (a.find_next_set(1) == 7) && (a.find_next_set(197) == -1), "test_3");
+
+    // bitwise operations
+    b.reset(0);
+    b.reset(7);
+    Assert(((a & b).count() == 27) && ((a | b).count() == 200) && ((a ^ b).count() == 173), "test_4");
+
+    cvector_bits c = a;
+    c.and_not(b);
+    Assert((c.count() == 2) && c[0] && c[7], "test_5");
+
+    // flip and resize keep the tail of the last word clear
+    c.flip_all();
+    Assert(c.count() == 198, "test_6");
+
+    c.resize(250, true);
+    Assert((c.count() == 248) && !c[0] && c[249], "test_7");
+
+    c.resize(70);
+    Assert((c.count() == 68) && (c.num_words() == 2), "test_8");
+
+    // set flags into idxs
+    cvector<index> idxs;
+    a.to_idxs(idxs);
+
+    bool isOk = (idxs.size() == 29);
+    for (index i = 0; i < idxs.size(); ++i)
+        isOk &= (idxs[i] == i * 7);
+    Assert(isOk, "test_9");
+
+    cvector_bits d;
+    for (int i = 0; i < 130; ++i)
+        d.push_back(i % 2);
+    Assert((d.size() == 130) && (d.count() == 65) && (d.find_first_set() == 1), "test_10");
+
+    PrintPassed();
+}
+
 
 // =================================================================================
 //                      test memory deallocation methods
@@ -1102,6 +2283,1097 @@ void VectorTests::TestPurge()
     PrintPassed();
 }
 
+///////////////////////////////////////////////////////////
+
+struct TelemetryElem
+{
+    int64_t key = 0;
+    int64_t payload = 0;
+};
+
+static int numReallocEvents = 0;
+
+void VectorTests::TestAllocTelemetry()
+{
+    PrintTestName("Test allocation telemetry:");
+
+    using namespace cvector_telemetry;
+
+    reset();
+    numReallocEvents = 0;
+    const realloc_hook prevHook = set_realloc_hook([](const realloc_event& e)
+    {
+        if (e.elemSize == sizeof(TelemetryElem))
+            numReallocEvents++;
+    });
+
+    // (checked only if telemetry is on)
+    [[maybe_unused]] unsigned growLine = 0;
+    [[maybe_unused]] vsize    finalCapacity = 0;
+    [[maybe_unused]] vsize    growCapacity = 0;
+    {
+        // growth by push_back: several reallocations at the same call site
+        cvector<TelemetryElem> v1;
+        growLine = std::source_location::current().line() + 2;
+        for (int i = 0; i < 100; ++i)
+            v1.push_back({ i, i });
+
+        // reserved in advance: a single allocation, no reallocations
+        cvector<TelemetryElem> v2;
+        v2.reserve(100);
+        for (int i = 0; i < 100; ++i)
+            v2.push_back({ i, i });
+
+        growCapacity  = v1.capacity();
+        finalCapacity = v1.capacity() + v2.capacity();
+    }
+
+    set_realloc_hook(prevHook);
+
+    const alloc_stats stats = get_type_stats<TelemetryElem>();
+
+#if CVECTOR_ENABLE_TELEMETRY
+    Assert(stats.numReallocs > 0, "test_1");
+    Assert(stats.numReallocs == (uint64_t)numReallocEvents, "test_2");
+    Assert(stats.numAllocs == stats.numReallocs + 2, "test_3");
+    Assert(stats.bytesMoved > 0, "test_4");
+    Assert(stats.peakCapacity >= 100, "test_5");
+
+    // all the buffers are released; slack is unused capacity of the final buffers
+    Assert(stats.numReleases == stats.numAllocs, "test_6");
+    Assert(stats.slackBytes == (uint64_t)(finalCapacity - 200) * sizeof(TelemetryElem), "test_7");
+
+    // the most reallocating site is the push_back loop of v1
+    const std::vector<site_stats> sites = get_site_stats();
+    const auto it = std::find_if(sites.begin(), sites.end(), [](const site_stats& s)
+    {
+        return s.typeName == typeid(TelemetryElem).name();
+    });
+
+    Assert(it != sites.end(), "test_8");
+    Assert(it->line == growLine, "test_9");
+    Assert(it->file.find("VectorTests.cpp") != std::string::npos, "test_10");
+    Assert(it->stats.numReallocs == stats.numReallocs, "test_11");
+
+    // slack of the final buffer of v1 is attributed to the site which allocated it
+    Assert(it->stats.slackBytes == (uint64_t)(growCapacity - 100) * sizeof(TelemetryElem), "test_12");
+#else
+    // nothing is recorded and call sites are empty
+    Assert(stats.numAllocs == 0, "test_1");
+    Assert(numReallocEvents == 0, "test_2");
+    Assert(std::is_empty_v<cvector<int>::call_site>, "test_3");
+#endif
+
+    reset();
+
+    PrintPassed();
+}
+
+
+// =================================================================================
+//                             test allocators
+// =================================================================================
+
+void VectorTests::TestArenaAllocator()
+{
+    PrintTestName("Test cvector<T, arena_allocator<T>>:");
+
+    arena_resource arena(256);
+
+    cvector<int, arena_allocator<int>>                 vInt{ arena_allocator<int>(&arena) };
+    cvector<std::string, arena_allocator<std::string>> vStr{ arena_allocator<std::string>(&arena) };
+
+    // a few blocks are chained while growing
+    for (int i = 0; i < 100; ++i)
+    {
+        vInt.push_back(i);
+        vStr.push_back(std::to_string(i));
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        Assert(vInt[i] == i, "test_1");
+        Assert(vStr[i] == std::to_string(i), "test_2");
+    }
+
+    // copy keeps the same arena
+    const cvector<int, arena_allocator<int>> vCopy(vInt);
+    Assert(vCopy.get_allocator() == vInt.get_allocator(), "test_3");
+    Assert(vCopy == vInt, "test_4");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestPoolAllocator()
+{
+    PrintTestName("Test cvector<T, pool_allocator<T>>:");
+
+    pool_resource pool;
+
+    cvector<int, pool_allocator<int>> v1{ pool_allocator<int>(&pool) };
+    cvector<int, pool_allocator<int>> v2({ 1,2,3 }, pool_allocator<int>(&pool));
+
+    // small buffers are taken from the pool, big ones -- from the upstream
+    for (int i = 0; i < 5000; ++i)
+        v1.push_back(i);
+
+    Assert((v1.size() == 5000) && (v1[4999] == 4999), "test_1");
+    AssertVectorsEqual(v2.data(), v1234.data(), 3);
+
+    // a released block is reused by the next allocation of the same size class
+    const int* oldData = v2.data();
+    v2.purge();
+    v2 = { 5,6,7 };
+    Assert(v2.data() == oldData, "test_2");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestFrameAllocator()
+{
+    PrintTestName("Test cvector<T, frame_allocator<T>>:");
+
+    frame_resource frameMem(1024);
+
+    // scratch output of search methods is allocated within the frame memory
+    {
+        cvector<index, frame_allocator<index>> idxs{ frame_allocator<index>(&frameMem) };
+        cvector<bool, frame_allocator<bool>>   flags{ frame_allocator<bool>(&frameMem) };
+        const int values[3] = { 1, 5, 10 };
+
+        v1to10.get_idxs(values, 3, idxs);
+        v1to10.binary_search(values, 3, flags);
+
+        AssertVectorsEqual(idxs.data(), cvector<index>{ 0, 4, 9 }.data(), 3);
+        Assert(flags[0] && flags[1] && flags[2], "test_1");
+        Assert(frameMem.used() > 0, "test_2");
+    }
+
+    // when the frame buffer is exhausted the memory is taken from the upstream
+    {
+        cvector<int, frame_allocator<int>> vBig{ frame_allocator<int>(&frameMem) };
+
+        for (int i = 0; i < 1000; ++i)
+            vBig.push_back(i);
+
+        Assert((vBig.size() == 1000) && (vBig[999] == 999), "test_3");
+    }
+
+    // release all the frame memory at once
+    frameMem.reset();
+    Assert(frameMem.used() == 0, "test_4");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestPmrAllocator()
+{
+    PrintTestName("Test pmr_cvector<T>:");
+
+    char                                buffer[1024];
+    std::pmr::monotonic_buffer_resource monotonic(buffer, sizeof(buffer));
+    arena_resource                      arena;
+
+    pmr_cvector<int>         vInt(&monotonic);
+    pmr_cvector<std::string> vStr({ "a","b","c","d" }, &arena);
+
+    for (int i = 0; i < 10; ++i)
+        vInt.push_back(i + 1);
+
+    AssertVectorsEqual(vInt.data(), v1to10.data(), 10);
+    AssertVectorsEqual(vStr.data(), vABCD.data(), 4);
+
+    // move between different resources: elements are moved one by one
+    pmr_cvector<std::string> vDst(&monotonic);
+    vDst = std::move(vStr);
+
+    AssertVectorsEqual(vDst.data(), vABCD.data(), 4);
+    Assert(vStr.empty(), "test_1");
+    Assert(vDst.get_allocator().resource() == &monotonic, "test_2");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestAlignedAllocator()
+{
+    PrintTestName("Test aligned_allocator<T, Alignment>:");
+
+    cvector<int, aligned_allocator<int, 64>>                             vLine;
+    cvector<std::string, aligned_allocator<std::string, 32>>             vStr{ "a","b","c","d" };
+    cvector<char, aligned_allocator<char, cvector_page_alignment>>       vPage(10, 'x');
+
+    // alignment is kept after each reallocation
+    bool isAligned = true;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        vLine.push_back(i);
+        isAligned &= ((uintptr_t)vLine.data() % 64 == 0);
+    }
+
+    Assert(isAligned && (vLine[999] == 999), "test_1");
+    Assert(((uintptr_t)vStr.data() % 32 == 0) && (vStr[3] == "d"), "test_2");
+    Assert(((uintptr_t)vPage.data() % cvector_page_alignment == 0) && (vPage[9] == 'x'), "test_3");
+
+    // memory can't be freed with another alignment
+    Assert((aligned_allocator<int, 64>() == aligned_allocator<float, 64>()) &&
+           (aligned_allocator<int, 64>() != aligned_allocator<int, 32>()), "test_4");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestHugePageAllocator()
+{
+    PrintTestName("Test huge_page_allocator<T>:");
+
+    using explicit_alloc = huge_page_allocator<int64_t, huge_pages::explicit_or_transparent>;
+
+    cvector<int64_t, huge_page_allocator<int64_t>> vSmall;
+    cvector<int64_t, huge_page_allocator<int64_t>> vBig;
+    cvector<int64_t, explicit_alloc>               vExplicit;
+
+    // small buffers: cache line aligned
+    vSmall.push_back(1);
+    Assert((uintptr_t)vSmall.data() % 64 == 0, "test_1");
+
+    // big buffers: 2 MB aligned, the capacity is rounded up to huge pages
+    constexpr vsize numElems = 300000;     // 2.4 MB
+    vBig.reserve(numElems);
+    vExplicit.reserve(numElems);
+
+    Assert(vBig.capacity() * sizeof(int64_t) == 4 * (1 << 20), "test_2");
+#if defined(__linux__)
+    Assert((uintptr_t)vBig.data() % (2 << 20) == 0, "test_3");
+#endif
+
+    for (vsize i = 0; i < numElems; ++i)
+    {
+        vBig.push_back(i * 2);
+        vExplicit.push_back(i * 2);
+    }
+
+    // growth over huge buffers and the search API work as usual
+    vBig.push_back(numElems * 2);
+    Assert((vBig.size() == numElems + 1) && (vBig.get_idx(1000) == 500) && vExplicit.binary_search(2000), "test_4");
+
+    vBig.shrink_to_fit();
+    Assert((vBig[numElems] == numElems * 2) && (vBig[12345] == 24690), "test_5");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestMremapAllocator()
+{
+    PrintTestName("Test mremap_allocator<T>: growth by remapping pages:");
+
+    cvector<int64_t, mremap_allocator<int64_t>>         vBig;
+    cvector<std::string, mremap_allocator<std::string>> vStr{ "a","b","c","d" };
+
+    // grow from malloc'ed buffers through the threshold (1 MB) to remapped ones
+    constexpr int64_t numElems = 1000000;      // 8 MB
+    bool isOk = true;
+
+    for (int64_t i = 0; i < numElems; ++i)
+    {
+        vBig.push_back(i);
+
+        // check the elements which were moved on the last growth
+        if (vBig.size() == vBig.capacity())
+            isOk &= (vBig[0] == 0) && (vBig[i / 2] == i / 2);
+    }
+
+    Assert(isOk && (vBig.size() == numElems) && (vBig[numElems - 1] == numElems - 1), "test_1");
+#if defined(__linux__)
+    // mapped buffers are page-aligned and their capacity is rounded up to pages
+    Assert(((uintptr_t)vBig.data() % 4096 == 0) && (vBig.capacity() * sizeof(int64_t) % 4096 == 0), "test_2");
+#endif
+
+    // shrink in place (and back under the threshold)
+    vBig.shrink_to_fit();
+    Assert((vBig.capacity() >= numElems) && (vBig[123456] == 123456), "test_3");
+
+    vBig.resize(1000);
+    vBig.shrink_to_fit();
+    Assert((vBig.capacity() == 1000) && (vBig[999] == 999) && (vBig.get_idx(500) == 500), "test_4");
+
+    // non-trivially relocatable types are moved one by one as usual
+    for (int i = 0; i < 100; ++i)
+        vStr.push_back(std::to_string(i));
+    Assert((vStr[3] == "d") && (vStr[103] == "99"), "test_5");
+
+    PrintPassed();
+}
+
+
+// =================================================================================
+//                             test small_cvector
+// =================================================================================
+
+void VectorTests::TestSmallVectorInline()
+{
+    PrintTestName("Test small_cvector<T, N>: elems are stored inline:");
+
+    small_cvector<int, 16>        vInt;
+    small_cvector<std::string, 4> vStr{ "a","b","c","d" };
+
+    for (int i = 0; i < 16; ++i)
+        vInt.push_back(i);
+
+    // check if the data is stored right inside the object
+    const char* objBegin = (const char*)&vInt;
+    const char* objEnd   = objBegin + sizeof(vInt);
+    const char* data     = (const char*)vInt.data();
+
+    Assert(vInt.is_inline() && (data >= objBegin) && (data < objEnd), "test_1");
+    Assert(vStr.is_inline() && (vStr.capacity() == 4), "test_2");
+
+    for (int i = 0; i < 16; ++i)
+        Assert(vInt[i] == i, "test_3");
+
+    AssertVectorsEqual(vStr.data(), vABCD.data(), 4);
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestSmallVectorSpill()
+{
+    PrintTestName("Test small_cvector<T, N>: spill into the heap:");
+
+    small_cvector<std::string, 4> vStr{ "a","b","c","d" };
+
+    // the 5th element doesn't fit into the inline buffer
+    vStr.push_back("e");
+    vStr.insert_before(0, "0");
+
+    Assert(!vStr.is_inline() && (vStr.size() == 6), "test_1");
+    AssertVectorsEqual(vStr.data(), cvector<std::string>{ "0","a","b","c","d","e" }.data(), 6);
+
+    // return back into the inline buffer
+    vStr.erase(0);
+    vStr.pop_back();
+    vStr.shrink_to_fit();
+
+    Assert(vStr.is_inline(), "test_2");
+    AssertVectorsEqual(vStr.data(), vABCD.data(), 4);
+
+    vStr.purge();
+    Assert(vStr.is_inline() && vStr.empty(), "test_3");
+
+    // the inline buffer is never shrunk (with a few elements or with none)
+    small_cvector<int, 8> vInt{ 1, 2 };
+    vInt.shrink_to_fit();
+    Assert(vInt.is_inline() && (vInt.capacity() == 8) && (vInt[1] == 2), "test_4");
+
+    vInt.clear();
+    vInt.shrink_to_fit();
+    Assert(vInt.is_inline() && (vInt.capacity() == 8), "test_5");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestSmallVectorSearch()
+{
+    PrintTestName("Test small_cvector<T, N>: sorted search methods:");
+
+    small_cvector<int, 8> v{ 1, 3, 5, 7, 10 };
+    const int             values[3] = { 1, 5, 10 };
+    cvector<index>        idxs;
+    cvector<bool>         flags;
+
+    // sorted insertion
+    v.insert_before(v.get_insert_idx(4), 4);
+    AssertVectorsEqual(v.data(), cvector<int>{ 1,3,4,5,7,10 }.data(), 6);
+
+    Assert(v.get_idx(7) == 4, "test_1");
+    Assert(v.binary_search(10) && !v.binary_search(2), "test_2");
+
+    v.get_idxs(values, 3, idxs);
+    AssertVectorsEqual(idxs, { 0, 3, 5 });
+
+    v.binary_search(values, 3, flags);
+    Assert(flags[0] && flags[1] && flags[2], "test_3");
+
+    Assert((v.find(3) == 1) && v.has_value(4), "test_4");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestSmallVectorCopyMove()
+{
+    PrintTestName("Test small_cvector<T, N>: copy/move:");
+
+    small_cvector<std::string, 4> vInline{ "a","b","c" };
+    small_cvector<std::string, 4> vHeap(vAtoH.begin(), vAtoH.end());
+
+    // copy: each vector has its own inline buffer
+    small_cvector<std::string, 4> vCopy1(vInline);
+    small_cvector<std::string, 4> vCopy2(vHeap);
+
+    Assert(vCopy1.is_inline() && (vCopy1.data() != vInline.data()), "test_1");
+    AssertVectorsEqual(vCopy1.data(), vABCD.data(), 3);
+    AssertVectorsEqual(vCopy2.data(), vAtoH.data(), 8);
+
+    // move inline elements
+    small_cvector<std::string, 4> vMove1(std::move(vInline));
+    Assert(vMove1.is_inline() && vInline.empty(), "test_2");
+    AssertVectorsEqual(vMove1.data(), vABCD.data(), 3);
+
+    // move heap buffer
+    const std::string* heapData = vHeap.data();
+    small_cvector<std::string, 4> vMove2(std::move(vHeap));
+    Assert((vMove2.data() == heapData) && vHeap.empty() && vHeap.is_inline(), "test_3");
+
+    // move/copy assignment
+    vMove1 = std::move(vMove2);
+    AssertVectorsEqual(vMove1.data(), vAtoH.data(), 8);
+
+    vMove2 = vCopy1;
+    AssertVectorsEqual(vMove2.data(), vABCD.data(), 3);
+
+    // move of a heap buffer between different upstream resources: the elements
+    // are moved into our resource (the source resource can die after that)
+    pool_resource                             pool2;
+    small_cvector<int, 4, pool_allocator<int>> vPool2{ pool_allocator<int>(&pool2) };
+    {
+        pool_resource                             pool1;
+        small_cvector<int, 4, pool_allocator<int>> vPool1{ pool_allocator<int>(&pool1) };
+
+        for (int i = 0; i < 100; ++i)
+            vPool1.push_back(i);
+
+        vPool2 = std::move(vPool1);
+    }
+    Assert((vPool2.size() == 100) && (vPool2[50] == 50) && (vPool2[99] == 99), "test_4");
+
+    // the same resource: the buffer is just stolen
+    small_cvector<int, 4, pool_allocator<int>> vPool3{ pool_allocator<int>(&pool2) };
+    const int* poolData = vPool2.data();
+
+    vPool3 = std::move(vPool2);
+    Assert((vPool3.data() == poolData) && (vPool3[50] == 50), "test_5");
+
+    PrintPassed();
+}
+
+
+// =================================================================================
+//                             test cvector_soa
+// =================================================================================
+
+void VectorTests::TestSoaRowOps()
+{
+    PrintTestName("Test cvector_soa<Ts...>: row-wise operations:");
+
+    cvector_soa<int, float, std::string>        soa;
+    const cvector_soa<int, float, std::string>& csoa = soa;
+
+    for (int i = 0; i < 10; ++i)
+        soa.push_back(i, i * 0.5f, std::to_string(i));
+
+    // all the columns have the same size and a single capacity
+    Assert((soa.size() == 10) && (soa.capacity() >= 10), "test_1");
+    Assert((csoa.column<0>().capacity() == soa.capacity()) &&
+           (csoa.column<2>().capacity() == soa.capacity()), "test_2");
+
+    // rows stay in sync after erase/insert
+    soa.erase(3);
+    soa.insert_before(0, 100, 50.0f, "100");
+    Assert((soa.size() == 10) && (soa.get<0>(0) == 100) && (soa.get<2>(0) == "100"), "test_3");
+    Assert((soa.get<0>(4) == 4) && (soa.get<1>(4) == 2.0f) && (soa.get<2>(4) == "4"), "test_4");
+
+    const index idxs[] = { 0, 1, 9 };
+    Assert(soa.erase_idxs(idxs, 3) == 3, "test_5");
+    Assert((soa.size() == 7) && (soa.get<0>(0) == 1) && (soa.get<2>(6) == "8"), "test_6");
+
+    soa.pop_back();
+    soa.resize(10);
+    Assert((soa.get<0>(9) == 0) && (soa.get<2>(9) == "") && (soa.get<2>(5) == "7"), "test_7");
+
+    soa.reserve(100);
+    Assert((soa.capacity() == 100) && (csoa.column<1>().capacity() == 100), "test_8");
+
+    soa.shrink_to_fit();
+    Assert((soa.capacity() == 10) && (csoa.column<0>().capacity() == 10), "test_9");
+
+    soa.purge();
+    Assert(soa.empty() && (soa.capacity() == 0) && (csoa.column<2>().capacity() == 0), "test_10");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestSoaColumns()
+{
+    PrintTestName("Test cvector_soa<Ts...>: access to columns:");
+
+    cvector_soa<int, float> soa(5);
+
+    // change a single column through its span
+    int id = 10;
+    for (int& value : soa.column<0>())
+        value = id++;
+
+    for (float& value : soa.column<1>())
+        value = 1.0f;
+
+    Assert((soa.data<0>()[4] == 14) && (soa.data<1>()[4] == 1.0f), "test_1");
+
+    // search and gather with the cvector API of a column
+    const cvector_soa<int, float>& csoa = soa;
+    Assert((csoa.column<0>().get_idx(12) == 2) && csoa.column<0>().binary_search(14), "test_2");
+
+    cvector<index> idxs{ 4, 0 };
+    cvector<int>   ids;
+    float          values[2];
+
+    csoa.get_data_by_idxs<0>(idxs, ids);
+    csoa.get_data_by_idxs<1>(idxs, values);
+    Assert((ids[0] == 14) && (ids[1] == 10) && (values[0] == 1.0f), "test_3");
+
+    PrintPassed();
+}
+
+
+// =================================================================================
+//                             test cvector_flat_map
+// =================================================================================
+
+void VectorTests::TestFlatMapSingle()
+{
+    PrintTestName("Test cvector_flat_map<K, V>: insert/find/erase a single pair:");
+
+    cvector_flat_map<int, std::string> map;
+
+    Assert((map.insert(5, "5") == 0) && (map.insert(1, "1") == 0) && (map.insert(9, "9") == 2), "test_1");
+    Assert((map.insert(5, "five") == 1) && (map.size() == 3), "test_2");
+
+    Assert((map.find(1) == 0) && (map.find(9) == 2) && (map.find(4) == -1) && (map.find(10) == -1), "test_3");
+    Assert(map.contains(5) && (*map.get(5) == "five") && (map.get(0) == nullptr), "test_4");
+
+    Assert(map.erase(1) && !map.erase(1) && (map.size() == 2), "test_5");
+    Assert((map.keys()[0] == 5) && (map.values()[1] == "9"), "test_6");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestFlatMapBulk()
+{
+    PrintTestName("Test cvector_flat_map<K, V>: bulk insert/erase/find:");
+
+    cvector_flat_map<int, int> map;
+
+    // even keys, then odd keys with some overlaps: merged in a single pass
+    cvector<int> keys1, values1, keys2, values2;
+    for (int i = 0; i < 100; i += 2) { keys1.push_back(i); values1.push_back(i * 10); }
+    for (int i = 1; i < 120; i += 3) { keys2.push_back(i); values2.push_back(-i); }
+
+    map.insert(keys1, values1);
+    map.insert(keys2, values2);
+
+    // compare with a map which is filled with single inserts
+    cvector_flat_map<int, int> expected;
+    for (index i = 0; i < keys1.size(); ++i) expected.insert(keys1[i], values1[i]);
+    for (index i = 0; i < keys2.size(); ++i) expected.insert(keys2[i], values2[i]);
+
+    Assert(map.keys() == expected.keys(), "test_1");
+    Assert(std::as_const(map).values() == std::as_const(expected).values(), "test_2");
+    Assert(std::is_sorted(map.keys().begin(), map.keys().end()), "test_3");
+
+    // batched search: missing keys give -1 / default value
+    const int      queries[] = { -1, 0, 4, 7, 99, 100, 118, 200 };
+    cvector<index> idxs;
+    cvector<int>   values;
+
+    map.find(queries, 8, idxs);
+    map.get_values(queries, 8, values, 12345);
+
+    bool isOk = true;
+    for (index i = 0; i < 8; ++i)
+    {
+        isOk &= (idxs[i] == map.find(queries[i]));
+        isOk &= (values[i] == ((idxs[i] != -1) ? map.value_at(idxs[i]) : 12345));
+    }
+    Assert(isOk && (values[2] == -4) && (values[1] == 0), "test_4");
+
+    // bulk erase (missing keys are ignored)
+    const int erased[] = { -5, 0, 1, 2, 3, 50, 118, 1000 };
+    const vsize oldSize = map.size();
+
+    Assert(map.erase(erased, 8) == 5, "test_5");
+    Assert((map.size() == oldSize - 5) && !map.contains(118) && map.contains(4), "test_6");
+
+    // values can be changed through the span
+    for (int& value : map.values())
+        value = 1;
+    Assert(*map.get(4) == 1, "test_7");
+
+    // unsorted or duplicated keys are rejected (the map is left unchanged)
+    cvector_flat_map<int, int> small;
+    small.insert(1, 10);
+    small.insert(5, 50);
+
+    const int unsortedKeys[]  = { 6, 0, 3 };
+    const int duplicateKeys[] = { 2, 2 };
+    const int someValues[]    = { 1, 2, 3 };
+
+    small.insert(unsortedKeys, someValues, 3);
+    small.insert(duplicateKeys, someValues, 2);
+    Assert((small.size() == 2) && (small.key_at(0) == 1) && (small.key_at(1) == 5), "test_8");
+
+    const int eraseKeys[] = { 5, 1 };
+    Assert((small.erase(eraseKeys, 2) == 0) && (small.size() == 2), "test_9");
+
+    // empty inputs (an empty cvector has no data) are valid
+    const cvector<int> noKeys;
+    cvector<int>       outValues{ 7 };
+    cvector<index>     outIdxs{ 7 };
+
+    small.insert(noKeys, noKeys);
+    small.get_values(noKeys, outValues);
+    small.find(noKeys.data(), 0, outIdxs);
+
+    Assert((small.erase(noKeys) == 0) && (small.size() == 2), "test_10");
+    Assert(outValues.empty() && outIdxs.empty(), "test_11");
+
+    PrintPassed();
+}
+
+
+// =================================================================================
+//                             test concurrent_cvector
+// =================================================================================
+
+void VectorTests::TestConcurrentPushBack()
+{
+    PrintTestName("Test concurrent_cvector<T>: push_back/grow_by from many threads:");
+
+    constexpr int numThreads   = 8;
+    constexpr int numPerThread = 5000;
+
+    concurrent_cvector<int, 16> v;
+
+    // the address of the first element must not change during growth
+    v.push_back(-1);
+    const int* pFirst = &v[0];
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&v, t]()
+        {
+            for (int i = 0; i < numPerThread; ++i)
+            {
+                // each 100th value is added as a range of 3 elements
+                if (i % 100 == 0)
+                    v.grow_by(3, t * numPerThread + i);
+                else
+                    v.push_back(t * numPerThread + i);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    const vsize numRanges = numThreads * (numPerThread / 100);
+    Assert(v.size() == 1 + numThreads * numPerThread + 2 * numRanges, "test_1");
+    Assert((&v[0] == pFirst) && (v.capacity() >= v.size()), "test_2");
+
+    // each value is added exactly once (ranges: 3 times)
+    cvector<int> flat;
+    v.flatten(flat);
+    std::sort(flat.begin(), flat.end());
+
+    bool isOk = (flat.size() == v.size()) && (flat[0] == -1);
+    index pos = 1;
+
+    for (int value = 0; value < numThreads * numPerThread; ++value)
+    {
+        const int numCopies = (value % numPerThread % 100 == 0) ? 3 : 1;
+
+        for (int k = 0; k < numCopies; ++k)
+            isOk &= (flat[pos++] == value);
+    }
+    Assert(isOk, "test_3");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestConcurrentGrowBy()
+{
+    PrintTestName("Test concurrent_cvector<T>: concurrent grow_by across segment boundaries:");
+
+    constexpr int numThreads = 8;
+    constexpr int numRanges  = 2000;      // per thread
+
+    // small segments: most ranges cross a boundary and many threads
+    // need the same new segment at once
+    concurrent_cvector<int64_t, 4> v;
+
+    struct range { index first; vsize count; int64_t value; };
+    std::vector<std::vector<range>> ranges(numThreads);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&v, &ranges, t]()
+        {
+            for (int i = 0; i < numRanges; ++i)
+            {
+                const vsize   count = 1 + (t * 7 + i * 13) % 37;
+                const int64_t value = (int64_t)t * numRanges + i;
+
+                ranges[t].push_back({ v.grow_by(count, value), count, value });
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // ranges don't overlap and cover the whole vector, each one is filled with its value
+    cvector<int64_t> flat;
+    v.flatten(flat);
+
+    std::vector<bool> isCovered(flat.size(), false);
+    bool isOk = (flat.size() == v.size());
+
+    for (const std::vector<range>& threadRanges : ranges)
+    {
+        for (const range& r : threadRanges)
+        {
+            for (index i = r.first; isOk && (i < r.first + r.count); ++i)
+            {
+                isOk &= (i < flat.size()) && !isCovered[i] && (flat[i] == r.value) && (v[i] == r.value);
+                isCovered[i] = true;
+            }
+        }
+    }
+    Assert(isOk, "test_1");
+    Assert(std::find(isCovered.begin(), isCovered.end(), false) == isCovered.end(), "test_2");
+    Assert(v.capacity() >= v.size(), "test_3");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestConcurrentSegments()
+{
+    PrintTestName("Test concurrent_cvector<T>: segments and flatten of non-trivial types:");
+
+    concurrent_cvector<std::string, 4> v;
+
+    for (int i = 0; i < 100; ++i)
+        v.push_back(std::to_string(i));
+
+    // segments: 4, 4, 8, 16, 32, 64 elements
+    vsize numSegments = 0;
+    vsize numElems    = 0;
+
+    v.for_each_segment([&](const std::string* data, const vsize count)
+    {
+        Assert(data[0] == std::to_string(numElems), "test_1");
+        numElems += count;
+        numSegments++;
+    });
+    Assert((numSegments == 6) && (numElems == 100) && (v.capacity() == 128), "test_2");
+
+    cvector<std::string> flat;
+    v.flatten(flat);
+    Assert((flat.size() == 100) && (flat[57] == "57") && (v[99] == "99"), "test_3");
+
+    v.clear();
+    Assert(v.empty() && (v.capacity() == 128) && (v.push_back("a") == 0), "test_4");
+
+    // a failed push is fatal (no unconstructed elements are left in the vector)
+    const std::string value = "b";
+    Assert(noexcept(v.push_back(value)) && noexcept(v.grow_by(2, value)), "test_5");
+
+    PrintPassed();
+}
+
+
+// =================================================================================
+//                             test segmented_cvector
+// =================================================================================
+
+void VectorTests::TestSegmentedGrowth()
+{
+    PrintTestName("Test segmented_cvector<T>: growth by chunks, stable addresses:");
+
+    segmented_cvector<std::string, 4> v;     // 16 elements per chunk
+
+    v.push_back("0");
+    const std::string* pFirst = &v[0];
+
+    for (int i = 1; i < 100; ++i)
+        v.push_back(std::to_string(i));
+
+    Assert((v.size() == 100) && (v.capacity() == 112) && (v.num_chunks() == 7), "test_1");
+    Assert((&v[0] == pFirst) && (v[17] == "17") && (v[99] == "99"), "test_2");
+
+    // contiguous chunks in order
+    vsize numElems = 0;
+    v.for_each_chunk([&](std::string* data, const vsize count)
+    {
+        Assert(data[0] == std::to_string(numElems), "test_3");
+        numElems += count;
+    });
+    Assert((numElems == 100) && (v.chunk(6).size() == 4), "test_4");
+
+    v.resize(20);
+    v.shrink_to_fit();
+    Assert((v.size() == 20) && (v.capacity() == 32) && (v[19] == "19"), "test_5");
+
+    v.resize(40, "x");
+    Assert((v[19] == "19") && (v[20] == "x") && (v[39] == "x"), "test_6");
+
+    segmented_cvector<std::string, 4> moved(std::move(v));
+    Assert((moved.size() == 40) && v.empty() && (&moved[0] == pFirst), "test_7");
+
+    moved.purge();
+    Assert(moved.empty() && (moved.capacity() == 0), "test_8");
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestSegmentedSearch()
+{
+    PrintTestName("Test segmented_cvector<T>: search/gather API:");
+
+    // sorted with duplicates across the chunk borders: 0,0,0,3,3,3,6...
+    cvector<int>                 ref;
+    segmented_cvector<int, 3>    v;                  // 8 elements per chunk
+
+    for (int i = 0; i < 500; ++i)
+    {
+        ref.push_back((i / 3) * 3);
+        v.push_back((i / 3) * 3);
+    }
+
+    bool isOk = true;
+    for (int value = -2; value < 505; ++value)
+    {
+        isOk &= (v.find(value)           == ref.find(value));
+        isOk &= (v.get_idx(value)        == ref.get_idx(value));
+        isOk &= (v.get_insert_idx(value) == ref.get_insert_idx(value));
+        isOk &= (v.binary_search(value)  == ref.binary_search(value));
+    }
+    Assert(isOk, "test_1");
+
+    // batched: sorted and unsorted queries
+    cvector<int> queries;
+    for (int value = -2; value < 505; value += 2)
+        queries.push_back(value);
+
+    cvector<index> idxs, expIdxs;
+    cvector<bool>  flags, expFlags;
+
+    for (const query_order order : { query_order::sorted, query_order::unsorted })
+    {
+        v.get_idxs(queries.data(), queries.size(), idxs, order);
+        ref.get_idxs(queries.data(), queries.size(), expIdxs, order);
+        Assert(idxs == expIdxs, "test_2");
+
+        v.get_insert_idxs(queries.data(), queries.size(), idxs, order);
+        ref.get_insert_idxs(queries.data(), queries.size(), expIdxs, order);
+        Assert(idxs == expIdxs, "test_3");
+
+        v.binary_search(queries.data(), queries.size(), flags, order);
+        ref.binary_search(queries.data(), queries.size(), expFlags, order);
+        Assert(flags == expFlags, "test_4");
+    }
+
+    Assert(v.binary_search(queries.data(), 10) == ref.binary_search(queries.data(), 10), "test_5");
+
+    // gather
+    cvector<index> gatherIdxs{ 499, 0, 8, 7, 250 };
+    cvector<int>   data, expData;
+
+    v.get_data_by_idxs(gatherIdxs, data);
+    ref.get_data_by_idxs(gatherIdxs, expData);
+    Assert(data == expData, "test_6");
+
+    PrintPassed();
+}
+
+
+// =================================================================================
+//                             test serialization
+// =================================================================================
+
+struct SpatialRecord
+{
+    int32_t id;
+    float   pos[3];
+    uint8_t flags;          // + 3 bytes of padding
+};
+
+static std::string GetTempFilePath(const char* name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestSaveLoad()
+{
+    PrintTestName("Test save(path)/load(path):");
+
+    const std::string path1 = GetTempFilePath("cvector_test_ints.bin");
+    const std::string path2 = GetTempFilePath("cvector_test_records.bin");
+
+    cvector<int> ints;
+    for (int i = 0; i < 10000; ++i)
+        ints.push_back(i * 3);
+
+    cvector<SpatialRecord> records;
+    for (int i = 0; i < 100; ++i)
+        records.push_back({ i, { (float)i, 0.5f, -1.0f }, (uint8_t)i });
+
+    Assert(ints.save(path1.c_str()) && records.save(path2.c_str()), "test_1");
+
+    // round trip
+    cvector<int>           loadedInts{ 1, 2, 3 };
+    cvector<SpatialRecord> loadedRecords;
+
+    Assert(loadedInts.load(path1.c_str()) && loadedRecords.load(path2.c_str()), "test_2");
+    Assert(std::equal(ints.begin(), ints.end(), loadedInts.begin(), loadedInts.end()), "test_3");
+    Assert((loadedRecords.size() == 100) && (memcmp(loadedRecords.data(), records.data(), 100 * sizeof(SpatialRecord)) == 0), "test_4");
+
+    // empty vector
+    cvector<int> empty;
+    Assert(empty.save(path1.c_str()) && loadedInts.load(path1.c_str()) && loadedInts.empty(), "test_5");
+
+    // the element type must match (size/alignment)
+    cvector<int64_t> wrongType;
+    Assert(!wrongType.load(path2.c_str()) && wrongType.empty(), "test_6");
+
+    // missing file
+    Assert(!loadedInts.load(GetTempFilePath("cvector_no_such_file.bin").c_str()), "test_7");
+
+    // the header count exceeds the payload: truncated file and corrupted count
+    Assert(ints.save(path1.c_str()), "test_8");
+    std::filesystem::resize_file(path1, std::filesystem::file_size(path1) - 100);
+    Assert(!loadedInts.load(path1.c_str()) && loadedInts.empty(), "test_9");
+
+    const uint64_t hugeCount = uint64_t(1) << 40;
+    FILE* file = fopen(path1.c_str(), "r+b");
+    fseek(file, (long)offsetof(cvector_io::file_header, count), SEEK_SET);
+    fwrite(&hugeCount, sizeof(hugeCount), 1, file);
+    fclose(file);
+
+    loadedInts = { 1, 2, 3 };
+    Assert(!loadedInts.load(path1.c_str()) && loadedInts.empty(), "test_10");
+
+    std::filesystem::remove(path1);
+    std::filesystem::remove(path2);
+
+    PrintPassed();
+}
+
+///////////////////////////////////////////////////////////
+
+void VectorTests::TestMappedView()
+{
+    PrintTestName("Test cvector_view<T>: memory-mapped file:");
+
+    const std::string path = GetTempFilePath("cvector_test_view.bin");
+
+    cvector<int> src;
+    for (int i = 0; i < 5000; ++i)
+        src.push_back(i * 2);
+
+    Assert(src.save(path.c_str()), "test_1");
+
+    cvector_view<int> view(path.c_str(), true);
+
+    Assert(view.is_open() && (view.size() == src.size()), "test_2");
+    Assert(std::equal(view.begin(), view.end(), src.begin(), src.end()), "test_3");
+    Assert(((uintptr_t)view.data() % cvector_io::dataAlignment) == 0, "test_4");
+
+    // the read-only API gives the same results as cvector
+    cvector<int> queries;
+    for (int i = -3; i < 10010; i += 7)
+        queries.push_back(i);
+
+    cvector<index> viewIdxs;
+    cvector<index> srcIdxs;
+    view.get_idxs(queries, viewIdxs);
+    src.get_idxs(queries, srcIdxs);
+    Assert(std::equal(viewIdxs.begin(), viewIdxs.end(), srcIdxs.begin(), srcIdxs.end()), "test_5");
+
+    view.get_idxs(queries.data(), queries.size(), viewIdxs, query_order::unsorted);
+    Assert(std::equal(viewIdxs.begin(), viewIdxs.end(), srcIdxs.begin(), srcIdxs.end()), "test_6");
+
+    bool isOk = true;
+    for (int q = -1; q < 200; ++q)
+    {
+        isOk &= (view.find(q)          == src.find(q));
+        isOk &= (view.has_value(q)     == src.has_value(q));
+        isOk &= (view.get_idx(q)       == src.get_idx(q));
+        isOk &= (view.binary_search(q) == src.binary_search(q));
+    }
+    Assert(isOk, "test_7");
+
+    cvector<index> idxs{ 4999, 0, 17, 18, 19, 2500 };
+    cvector<int>   viewData;
+    cvector<int>   srcData;
+    view.get_data_by_idxs(idxs, viewData);
+    src.get_data_by_idxs(idxs, srcData);
+    Assert(std::equal(viewData.begin(), viewData.end(), srcData.begin(), srcData.end()), "test_8");
+
+    // move the mapping into another view
+    cvector_view<int> view2(std::move(view));
+    Assert(!view.is_open() && view2.is_open() && (view2[4999] == 9998), "test_9");
+    view2.close();
+    Assert(!view2.is_open() && view2.empty(), "test_10");
+
+    // wrong type and corrupted data are rejected
+    cvector_view<double> wrongView(path.c_str());
+    Assert(!wrongView.is_open(), "test_11");
+
+    {
+        FILE* file = fopen(path.c_str(), "r+b");
+        fseek(file, (long)cvector_io::data_offset<int>() + 100, SEEK_SET);
+        fputc(0x7F, file);
+        fclose(file);
+    }
+
+    Assert(view2.open(path.c_str(), false) && !view2.verify_checksum(), "test_12");
+    Assert(!view2.open(path.c_str(), true), "test_13");
+
+    std::filesystem::remove(path);
+
+    PrintPassed();
+}
+
 
 // =================================================================================
 //                              private helpers
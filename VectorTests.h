@@ -28,11 +28,17 @@ public:
     void TestPushBack();
     void TestPopBack();
     void TestErase();
+    void TestEraseIdxs();
+    void TestEraseValues();
+    void TestEraseIf();
     void TestClear();
 
     void TestReserve();
+    void TestGrowthPolicy();
     void TestResize();
     void TestResizeWithVal();
+    void TestResizeDefaultInit();
+    void TestRawStorageLifetime();
 
     void TestOperatorEqual();
     void TestOperatorCopyAssignment();
@@ -43,30 +49,80 @@ public:
     void TestShiftRight();
     void TestShiftLeft();
     void TestInsertBefore();
+    void TestRelocatableType();
 
     void TestAppendCopyVector();
     void TestAppendMoveVector();
 
     // test seach methods
     void TestFind();
+    void TestFindSimd();
+    void TestFindAny();
     void TestGetIdx();
     void TestGetIdxsFromRawArr();
     void TestGetIdxsFromVector();
     void TestGetDataByIdxs1();
     void TestGetDataByIdxs2();
+    void TestGatherByIdxs();
     void TestGetInsertIdx();
     void TestGetInsertIdxs();
     void TestSortedInsertionMultiple();
+    void TestInsertSorted();
+    void TestBranchlessSearch();
+    void TestSearchIndex();
+    void TestConstexprTable();
+    void TestSpan();
+    void TestSortedQueries();
+    void TestExecutionPolicies();
 
     void TestHasValue();
     void TestBinarySearchForSingle();
     void TestBinarySearchForMultiple();
     void TestBinarySearchForRawMultiple();
     void TestBinarySearchForRawMultipleOutFlags();
+    void TestBinarySearchPackedFlags();
+    void TestPackedFlags();
 
     // test memory deallocation
     void TestShrinkToFit();
     void TestPurge();
+    void TestAllocTelemetry();
+
+    // test allocators
+    void TestArenaAllocator();
+    void TestPoolAllocator();
+    void TestFrameAllocator();
+    void TestPmrAllocator();
+    void TestAlignedAllocator();
+    void TestHugePageAllocator();
+    void TestMremapAllocator();
+
+    // test small_cvector
+    void TestSmallVectorInline();
+    void TestSmallVectorSpill();
+    void TestSmallVectorSearch();
+    void TestSmallVectorCopyMove();
+
+    // test cvector_soa
+    void TestSoaRowOps();
+    void TestSoaColumns();
+
+    // test cvector_flat_map
+    void TestFlatMapSingle();
+    void TestFlatMapBulk();
+
+    // test concurrent_cvector
+    void TestConcurrentPushBack();
+    void TestConcurrentGrowBy();
+    void TestConcurrentSegments();
+
+    // test segmented_cvector
+    void TestSegmentedGrowth();
+    void TestSegmentedSearch();
+
+    // test serialization
+    void TestSaveLoad();
+    void TestMappedView();
 
 private:
 
@@ -0,0 +1,120 @@
+// =================================================================================
+// Filename:     BinarySearchBench.cpp
+// Description:  benchmark: branchless prefetching binary search of cvector
+//               (get_idxs) and of Eytzinger search index (cvector_search_index)
+//               against std::lower_bound for sorted arrays which fit
+//               into L1 / L2 / L3 / DRAM;
+//
+//               build (release!) and run (see CMakeLists.txt):
+//                   cmake -S benchmarks -B build_bench
+//                   cmake --build build_bench --config Release --target binary_search_bench
+// =================================================================================
+#include "cvector.h"
+#include "cvector_search_index.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+
+struct BenchCase
+{
+    const char* name;
+    vsize       numElems;
+};
+
+// ----------------------------------------------------
+
+template <typename Func>
+double MeasureNsPerQuery(Func&& func, const vsize numQueries)
+{
+    // run the function a few times and return the best time per query
+
+    double bestNs = 1e30;
+
+    for (int run = 0; run < 5; ++run)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        func();
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        bestNs = std::min(bestNs, ns / numQueries);
+    }
+
+    return bestNs;
+}
+
+// ----------------------------------------------------
+
+int main()
+{
+    constexpr vsize numQueries = 1 << 20;
+
+    const BenchCase cases[] =
+    {
+        { "L1   (16 KB)",  (16 << 10)  / sizeof(int) },
+        { "L2   (512 KB)", (512 << 10) / sizeof(int) },
+        { "L3   (16 MB)",  (16 << 20)  / sizeof(int) },
+        { "DRAM (256 MB)", (256 << 20) / sizeof(int) },
+    };
+
+    std::mt19937 rng(12345);
+
+    printf("%-16s %16s %16s %16s %10s %10s\n",
+           "size", "std (ns/query)", "cvector (ns/q)", "index (ns/q)", "speedup", "idx spdup");
+
+    for (const BenchCase& bench : cases)
+    {
+        // sorted array of even numbers
+        cvector<int> arr;
+        arr.resize_default_init(bench.numElems);
+
+        for (vsize i = 0; i < bench.numElems; ++i)
+            arr[i] = (int)(i * 2);
+
+        // random queries over the whole range
+        std::uniform_int_distribution<int> dist(0, (int)(bench.numElems * 2));
+        cvector<int> queries;
+        queries.resize_default_init(numQueries);
+
+        for (vsize i = 0; i < numQueries; ++i)
+            queries[i] = dist(rng);
+
+        cvector<index> idxsStd(numQueries, 0);
+        cvector<index> idxsCvec;
+        cvector<index> idxsIndex;
+
+        const cvector_search_index<int> searchIdx(arr);
+
+        const double nsStd = MeasureNsPerQuery([&]()
+        {
+            for (vsize i = 0; i < numQueries; ++i)
+                idxsStd[i] = std::distance(arr.begin(), std::lower_bound(arr.begin(), arr.end(), queries[i]));
+        }, numQueries);
+
+        const double nsCvec = MeasureNsPerQuery([&]()
+        {
+            arr.get_idxs(queries, idxsCvec);
+        }, numQueries);
+
+        const double nsIndex = MeasureNsPerQuery([&]()
+        {
+            searchIdx.get_idxs(queries.data(), queries.size(), idxsIndex);
+        }, numQueries);
+
+        // make sure that results are the same
+        for (vsize i = 0; i < numQueries; ++i)
+        {
+            if ((idxsStd[i] != idxsCvec[i]) || (idxsStd[i] != idxsIndex[i]))
+            {
+                printf("ERROR: results mismatch\n");
+                return -1;
+            }
+        }
+
+        printf("%-16s %16.2f %16.2f %16.2f %9.2fx %9.2fx\n",
+               bench.name, nsStd, nsCvec, nsIndex, nsStd / nsCvec, nsStd / nsIndex);
+    }
+
+    return 0;
+}
@@ -0,0 +1,456 @@
+// =================================================================================
+// Filename:     CvectorBench.cpp
+// Description:  benchmark suite: cvector against std::vector for the basic
+//               operations (push_back, reserve, resize, insert_before, erase,
+//               append, copy/move) and each search method, for int / 64-byte POD /
+//               std::string elements and arrays from L1 to DRAM size;
+//
+//               results are printed as JSON (compare two runs with compare_bench.py):
+//                   cvector_bench [--quick] [--filter <substr>] [--out <file.json>]
+//
+//               --quick   only L1 and L2 sized arrays
+//               --filter  run only benchmarks which names contain the substring
+//                         (names look like "get_idxs/int/L2")
+//               --out     write JSON into the file instead of stdout
+// =================================================================================
+#include "cvector.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// =================================================================================
+// element types
+// =================================================================================
+struct Pod64
+{
+    int  key;
+    char payload[60];
+
+    bool operator<(const Pod64& rhs)  const { return key < rhs.key; }
+    bool operator==(const Pod64& rhs) const { return key == rhs.key; }
+};
+
+static_assert(sizeof(Pod64) == 64, "Pod64 must take exactly 64 bytes");
+
+// ----------------------------------------------------
+
+template <typename T> T           MakeValue(const int key);
+template <>           int         MakeValue<int>(const int key) { return key; }
+
+template <>
+Pod64 MakeValue<Pod64>(const int key)
+{
+    Pod64 pod;
+    memset(&pod, 0, sizeof(pod));
+    pod.key = key;
+    return pod;
+}
+
+template <>
+std::string MakeValue<std::string>(const int key)
+{
+    // longer than SSO buffer so each string owns heap memory;
+    // zero padding keeps the same order as for keys
+    char buf[32];
+    snprintf(buf, sizeof(buf), "entity_%010d", key);
+    return buf;
+}
+
+template <typename T> const char* TypeName();
+template <>           const char* TypeName<int>()         { return "int"; }
+template <>           const char* TypeName<Pod64>()       { return "pod64"; }
+template <>           const char* TypeName<std::string>() { return "string"; }
+
+
+// =================================================================================
+// measurement and results
+// =================================================================================
+struct BenchOptions
+{
+    bool        quick = false;
+    const char* filter = nullptr;
+    const char* outPath = nullptr;
+};
+
+struct BenchResult
+{
+    std::string name;
+    const char* impl;
+    vsize       numElems;
+    vsize       numOps;
+    double      nsPerOp;
+};
+
+struct SizeClass
+{
+    const char* name;
+    size_t      bytes;
+};
+
+static std::vector<BenchResult> g_Results;
+static volatile size_t          g_Sink = 0;      // prevents the optimizer from dropping the work
+
+// ----------------------------------------------------
+
+template <typename Setup, typename Func>
+double MeasureNs(Setup&& setup, Func&& func)
+{
+    // run setup (not timed) and func a few times: at least 3 runs and ~50 ms
+    // in total (but no more than 50 runs); return the best time of func
+
+    using clock = std::chrono::steady_clock;
+
+    double bestNs  = 1e300;
+    double totalNs = 0;
+
+    for (int run = 0; (run < 3) || ((totalNs < 50e6) && (run < 50)); ++run)
+    {
+        setup();
+
+        const auto start = clock::now();
+        func();
+        const auto end = clock::now();
+
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        bestNs   = std::min(bestNs, ns);
+        totalNs += ns;
+    }
+
+    return bestNs;
+}
+
+// ----------------------------------------------------
+
+bool IsSelected(const BenchOptions& opts, const std::string& name)
+{
+    return !opts.filter || (name.find(opts.filter) != std::string::npos);
+}
+
+// ----------------------------------------------------
+
+template <typename CSetup, typename CFunc, typename SSetup, typename SFunc>
+void RunPair(
+    const BenchOptions& opts,
+    const std::string& name,
+    const vsize numElems,
+    const vsize numOps,
+    CSetup&& cvecSetup, CFunc&& cvecFunc,
+    SSetup&& stdSetup,  SFunc&& stdFunc)
+{
+    // measure cvector and std::vector versions of the same operation
+
+    if (!IsSelected(opts, name))
+        return;
+
+    const double cvecNs = MeasureNs(cvecSetup, cvecFunc) / (double)numOps;
+    const double stdNs  = MeasureNs(stdSetup,  stdFunc)  / (double)numOps;
+
+    g_Results.push_back({ name, "cvector",     numElems, numOps, cvecNs });
+    g_Results.push_back({ name, "std::vector", numElems, numOps, stdNs });
+
+    fprintf(stderr, "%-36s cvector %10.2f ns   std::vector %10.2f ns   (x%.2f)\n",
+            name.c_str(), cvecNs, stdNs, stdNs / cvecNs);
+}
+
+
+// =================================================================================
+// benchmarks for a single element type and array size
+// =================================================================================
+template <typename T>
+void BenchTypeAndSize(const BenchOptions& opts, const SizeClass& sizeClass)
+{
+    const vsize  n      = std::max<vsize>(16, (vsize)(sizeClass.bytes / sizeof(T)));
+    const std::string suffix = std::string("/") + TypeName<T>() + "/" + sizeClass.name;
+    auto         nameOf = [&suffix](const char* op) { return std::string(op) + suffix; };
+
+    std::mt19937 rng(12345);
+
+    // sorted source data: even keys
+    std::vector<T> stdSorted;
+    stdSorted.reserve(n);
+
+    for (vsize i = 0; i < n; ++i)
+        stdSorted.push_back(MakeValue<T>((int)(i * 2)));
+
+    const cvector<T> cvSorted(stdSorted.data(), stdSorted.data() + n);
+
+    // random queries over the whole range of keys (about a half of them exist)
+    const vsize numQueries = std::min<vsize>(n, 1 << 16);
+    std::uniform_int_distribution<int> keyDist(0, (int)(n * 2));
+    std::uniform_int_distribution<vsize> idxDist(0, n - 1);
+
+    std::vector<T>     stdQueries;
+    std::vector<vsize> stdIdxs;
+
+    for (vsize i = 0; i < numQueries; ++i)
+    {
+        stdQueries.push_back(MakeValue<T>(keyDist(rng)));
+        stdIdxs.push_back(idxDist(rng));
+    }
+
+    const cvector<T>     cvQueries(stdQueries.data(), stdQueries.data() + numQueries);
+    const cvector<index> cvIdxs(stdIdxs.data(), stdIdxs.data() + numQueries);
+
+    std::vector<T> stdSortedQueries(stdQueries);
+    std::sort(stdSortedQueries.begin(), stdSortedQueries.end());
+    const cvector<T> cvSortedQueries(stdSortedQueries.data(), stdSortedQueries.data() + numQueries);
+
+    cvector<T>     cv;
+    std::vector<T> sv;
+    auto noSetup = []() {};
+
+
+    // ---------------------------------------------
+    // modification
+    // ---------------------------------------------
+
+    RunPair(opts, nameOf("push_back"), n, n,
+        [&]() { cv.purge(); },
+        [&]() { for (vsize i = 0; i < n; ++i) cv.push_back(stdSorted[i]); },
+        [&]() { sv = std::vector<T>(); },
+        [&]() { for (vsize i = 0; i < n; ++i) sv.push_back(stdSorted[i]); });
+
+    RunPair(opts, nameOf("reserve+push_back"), n, n,
+        [&]() { cv.purge(); },
+        [&]() { cv.reserve(n); for (vsize i = 0; i < n; ++i) cv.push_back(stdSorted[i]); },
+        [&]() { sv = std::vector<T>(); },
+        [&]() { sv.reserve(n); for (vsize i = 0; i < n; ++i) sv.push_back(stdSorted[i]); });
+
+    RunPair(opts, nameOf("resize"), n, n,
+        [&]() { cv.purge(); },
+        [&]() { cv.resize(n); },
+        [&]() { sv = std::vector<T>(); },
+        [&]() { sv.resize(n); });
+
+    // each insert/erase moves the tail so do fewer of them for big arrays
+    const vsize numEdits = std::min(std::clamp<vsize>((1 << 22) / n, 4, 256), n / 4);
+    std::vector<vsize> editPositions;
+
+    for (vsize i = 0; i < numEdits; ++i)
+        editPositions.push_back(idxDist(rng) / 2);
+
+    RunPair(opts, nameOf("insert_before"), n, numEdits,
+        [&]() { cv = cvSorted; },
+        [&]() { for (const vsize pos : editPositions) cv.insert_before(pos, stdSorted[pos]); },
+        [&]() { sv = stdSorted; },
+        [&]() { for (const vsize pos : editPositions) sv.insert(sv.begin() + pos, stdSorted[pos]); });
+
+    RunPair(opts, nameOf("erase"), n, numEdits,
+        [&]() { cv = cvSorted; },
+        [&]() { for (const vsize pos : editPositions) cv.erase(pos); },
+        [&]() { sv = stdSorted; },
+        [&]() { for (const vsize pos : editPositions) sv.erase(sv.begin() + pos); });
+
+    const vsize half = n / 2;
+    const cvector<T>     cvHalf(stdSorted.data(), stdSorted.data() + half);
+    const std::vector<T> svHalf(stdSorted.begin(), stdSorted.begin() + half);
+
+    RunPair(opts, nameOf("append_vector"), n, half,
+        [&]() { cv = cvHalf; },
+        [&]() { cv.append_vector(cvHalf); },
+        [&]() { sv = svHalf; },
+        [&]() { sv.insert(sv.end(), svHalf.begin(), svHalf.end()); });
+
+    // copy construction (+ destruction of the copy)
+    RunPair(opts, nameOf("copy"), n, n,
+        noSetup,
+        [&]() { cvector<T> copy(cvSorted); g_Sink = g_Sink + copy.size(); },
+        noSetup,
+        [&]() { std::vector<T> copy(stdSorted); g_Sink = g_Sink + copy.size(); });
+
+    // move there and back again
+    constexpr vsize numMoves = 1000;
+    cvector<T>      cvOther;
+    std::vector<T>  svOther;
+
+    RunPair(opts, nameOf("move"), n, numMoves * 2,
+        [&]() { cv = cvSorted; },
+        [&]() { for (vsize i = 0; i < numMoves; ++i) { cvOther = std::move(cv); cv = std::move(cvOther); } },
+        [&]() { sv = stdSorted; },
+        [&]() { for (vsize i = 0; i < numMoves; ++i) { svOther = std::move(sv); sv = std::move(svOther); } });
+
+    cv.purge();
+    cvOther.purge();
+    sv = std::vector<T>();
+
+
+    // ---------------------------------------------
+    // linear search
+    // ---------------------------------------------
+
+    // each query scans about a half of the array
+    const vsize numLinearQueries = std::min(std::clamp<vsize>((1 << 24) / n, 1, 1000), numQueries);
+
+    RunPair(opts, nameOf("find"), n, numLinearQueries,
+        noSetup,
+        [&]() { for (vsize i = 0; i < numLinearQueries; ++i) g_Sink = g_Sink + cvSorted.find(stdQueries[i]); },
+        noSetup,
+        [&]() { for (vsize i = 0; i < numLinearQueries; ++i) g_Sink = g_Sink + (std::find(stdSorted.begin(), stdSorted.end(), stdQueries[i]) - stdSorted.begin()); });
+
+    RunPair(opts, nameOf("has_value"), n, numLinearQueries,
+        noSetup,
+        [&]() { for (vsize i = 0; i < numLinearQueries; ++i) g_Sink = g_Sink + cvSorted.has_value(stdQueries[i]); },
+        noSetup,
+        [&]() { for (vsize i = 0; i < numLinearQueries; ++i) g_Sink = g_Sink + (std::find(stdSorted.begin(), stdSorted.end(), stdQueries[i]) != stdSorted.end()); });
+
+
+    // ---------------------------------------------
+    // sorted search
+    // ---------------------------------------------
+
+    RunPair(opts, nameOf("get_idx"), n, numQueries,
+        noSetup,
+        [&]() { for (const T& q : stdQueries) g_Sink = g_Sink + cvSorted.get_idx(q); },
+        noSetup,
+        [&]() { for (const T& q : stdQueries) g_Sink = g_Sink + (std::upper_bound(stdSorted.begin(), stdSorted.end(), q) - stdSorted.begin() - 1); });
+
+    RunPair(opts, nameOf("binary_search"), n, numQueries,
+        noSetup,
+        [&]() { for (const T& q : stdQueries) g_Sink = g_Sink + cvSorted.binary_search(q); },
+        noSetup,
+        [&]() { for (const T& q : stdQueries) g_Sink = g_Sink + std::binary_search(stdSorted.begin(), stdSorted.end(), q); });
+
+    cvector<index>         cvOutIdxs;
+    std::vector<ptrdiff_t> svOutIdxs(numQueries);
+
+    RunPair(opts, nameOf("get_idxs"), n, numQueries,
+        noSetup,
+        [&]() { cvSorted.get_idxs(cvQueries, cvOutIdxs); },
+        noSetup,
+        [&]() { for (vsize i = 0; i < numQueries; ++i) svOutIdxs[i] = std::lower_bound(stdSorted.begin(), stdSorted.end(), stdQueries[i]) - stdSorted.begin(); });
+
+    RunPair(opts, nameOf("get_idxs_sorted_queries"), n, numQueries,
+        noSetup,
+        [&]() { cvSorted.get_idxs(cvSortedQueries, cvOutIdxs); },
+        noSetup,
+        [&]() { for (vsize i = 0; i < numQueries; ++i) svOutIdxs[i] = std::lower_bound(stdSorted.begin(), stdSorted.end(), stdSortedQueries[i]) - stdSorted.begin(); });
+
+    RunPair(opts, nameOf("get_insert_idxs"), n, numQueries,
+        noSetup,
+        [&]() { cvSorted.get_insert_idxs(cvQueries, cvOutIdxs); },
+        noSetup,
+        [&]() { for (vsize i = 0; i < numQueries; ++i) svOutIdxs[i] = std::upper_bound(stdSorted.begin(), stdSorted.end(), stdQueries[i]) - stdSorted.begin(); });
+
+    // NOTE: cvector searches value i in [begin+i, end) (see cvector::binary_search),
+    //       std::vector version searches the whole array: the work is about the same
+    cvector<bool>     cvFlags;
+    std::vector<char> svFlags(numQueries);
+
+    RunPair(opts, nameOf("binary_search_flags"), n, numQueries,
+        noSetup,
+        [&]() { cvSorted.binary_search(cvQueries.data(), numQueries, cvFlags); },
+        noSetup,
+        [&]() { for (vsize i = 0; i < numQueries; ++i) svFlags[i] = std::binary_search(stdSorted.begin(), stdSorted.end(), stdQueries[i]); });
+
+
+    // ---------------------------------------------
+    // gather
+    // ---------------------------------------------
+
+    cvector<T>     cvGathered;
+    std::vector<T> svGathered(numQueries);
+
+    RunPair(opts, nameOf("get_data_by_idxs"), n, numQueries,
+        noSetup,
+        [&]() { cvSorted.get_data_by_idxs(cvIdxs, cvGathered); },
+        noSetup,
+        [&]() { for (vsize i = 0; i < numQueries; ++i) svGathered[i] = stdSorted[stdIdxs[i]]; });
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+void BenchType(const BenchOptions& opts)
+{
+    const SizeClass sizes[] =
+    {
+        { "L1",   16 << 10 },
+        { "L2",   256 << 10 },
+        { "L3",   8 << 20 },
+        { "DRAM", 128 << 20 },
+    };
+
+    const int numSizes = opts.quick ? 2 : 4;
+
+    for (int i = 0; i < numSizes; ++i)
+        BenchTypeAndSize<T>(opts, sizes[i]);
+}
+
+
+// =================================================================================
+// JSON output
+// =================================================================================
+void WriteJson(FILE* file, const BenchOptions& opts)
+{
+    fprintf(file, "{\n");
+    fprintf(file, "  \"suite\": \"cvector_bench\",\n");
+    fprintf(file, "  \"quick\": %s,\n", opts.quick ? "true" : "false");
+    fprintf(file, "  \"results\": [\n");
+
+    for (size_t i = 0; i < g_Results.size(); ++i)
+    {
+        const BenchResult& res = g_Results[i];
+
+        fprintf(file, "    { \"name\": \"%s\", \"impl\": \"%s\", \"elems\": %lld, \"ops\": %lld, \"ns_per_op\": %.4f }%s\n",
+                res.name.c_str(),
+                res.impl,
+                (long long)res.numElems,
+                (long long)res.numOps,
+                res.nsPerOp,
+                (i + 1 < g_Results.size()) ? "," : "");
+    }
+
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+}
+
+// ----------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    BenchOptions opts;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        {
+            opts.quick = true;
+        }
+        else if ((strcmp(argv[i], "--filter") == 0) && (i + 1 < argc))
+        {
+            opts.filter = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--out") == 0) && (i + 1 < argc))
+        {
+            opts.outPath = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--quick] [--filter <substr>] [--out <file.json>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    BenchType<int>(opts);
+    BenchType<Pod64>(opts);
+    BenchType<std::string>(opts);
+
+    FILE* file = opts.outPath ? fopen(opts.outPath, "w") : stdout;
+
+    if (!file)
+    {
+        fprintf(stderr, "can't open file for writing: %s\n", opts.outPath);
+        return 1;
+    }
+
+    WriteJson(file, opts);
+
+    if (file != stdout)
+        fclose(file);
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+# =================================================================================
+# Filename:     compare_bench.py
+# Description:  compare two JSON outputs of cvector_bench (baseline and current)
+#               and flag regressions: a benchmark is a regression if its time
+#               per operation grew by more than the threshold;
+#
+#               usage:
+#                   compare_bench.py baseline.json current.json [--threshold 0.05]
+#                                    [--impl cvector]
+#
+#               exit code is 1 if there is any regression (so it can be used in CI)
+# =================================================================================
+import argparse
+import json
+import sys
+
+
+def load_results(path):
+    with open(path) as file:
+        data = json.load(file)
+
+    return {(res["name"], res["impl"]): res["ns_per_op"] for res in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare two cvector_bench runs")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative slowdown which is treated as a regression (default: 0.05)")
+    parser.add_argument("--impl", default=None,
+                        help="compare only this implementation (cvector or std::vector)")
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline)
+    current  = load_results(args.current)
+
+    keys = [key for key in current if key in baseline]
+    if args.impl:
+        keys = [key for key in keys if key[1] == args.impl]
+
+    num_regressions  = 0
+    num_improvements = 0
+
+    print(f"{'benchmark':<40} {'impl':<12} {'base ns':>10} {'curr ns':>10} {'change':>9}")
+
+    for key in keys:
+        base = baseline[key]
+        curr = current[key]
+        change = (curr - base) / base if base > 0 else 0.0
+
+        mark = ""
+        if change > args.threshold:
+            mark = "REGRESSION"
+            num_regressions += 1
+        elif change < -args.threshold:
+            mark = "improved"
+            num_improvements += 1
+
+        print(f"{key[0]:<40} {key[1]:<12} {base:>10.2f} {curr:>10.2f} {change * 100:>+8.1f}% {mark}")
+
+    missing = [key for key in baseline if key not in current]
+    for key in missing:
+        print(f"{key[0]:<40} {key[1]:<12} missing in the current run")
+
+    print(f"\n{len(keys)} compared, {num_regressions} regressions, "
+          f"{num_improvements} improvements (threshold {args.threshold * 100:.1f}%)")
+
+    return 1 if num_regressions > 0 else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,311 @@
+// =================================================================================
+// Filename:     concurrent_cvector.h
+// Description:  append-only vector which many threads can grow at once:
+//               push_back()/grow_by() reserve indices with a single atomic add,
+//               and the elements are stored in segments which are never moved
+//               (so the addresses of elements are stable);
+//
+//               segment k holds (FirstSegment << (k-1)) elements (segment 0 has
+//               FirstSegment), so an index is mapped to its segment with a bit scan;
+//               a missing segment is allocated by the first thread which needs it
+//               (the others wait for it);
+//
+//               NOTE: reading elements which are being constructed by other threads
+//               needs an external synchronization (e.g. join the workers first);
+//               clear(), flatten() and the destructor mustn't run concurrently
+//               with push_back()/grow_by(); a stateful Alloc must be thread-safe;
+//               a failed push (segment allocation or element constructor) is fatal
+//
+//               usage:
+//                   concurrent_cvector<EntityID> visible;
+//                   // ... on any thread:
+//                   visible.push_back(id);
+//                   // ... after the job is done:
+//                   visible.flatten(outIds);
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <thread>
+
+
+template <typename T, vsize FirstSegment = 64, typename Alloc = std::allocator<T>>
+class concurrent_cvector
+{
+    static_assert((FirstSegment > 0) && std::has_single_bit((size_t)FirstSegment),
+        "concurrent_cvector: the size of the first segment must be a power of two");
+
+public:
+    using allocator_type = Alloc;
+
+    // enough segments to address any vsize index
+    static constexpr int maxSegments = 64 - std::countr_zero((size_t)FirstSegment);
+
+    concurrent_cvector() {}
+    explicit concurrent_cvector(const Alloc& alloc) : alloc_(alloc) {}
+    ~concurrent_cvector();
+
+    concurrent_cvector(const concurrent_cvector&) = delete;
+    concurrent_cvector& operator=(const concurrent_cvector&) = delete;
+
+
+    // getters
+    inline T&       operator[](const index i)       { return segments_[segment_of(i)].load(std::memory_order_acquire)[i - segment_base(segment_of(i))]; }
+    inline const T& operator[](const index i) const { return segments_[segment_of(i)].load(std::memory_order_acquire)[i - segment_base(segment_of(i))]; }
+
+    inline vsize    size()     const { return size_.load(std::memory_order_acquire); }
+    inline bool     empty()    const { return size() == 0; }
+    inline vsize    capacity() const;
+
+    // call func(T* data, vsize count) for each contiguous part of elements in order
+    template <typename Func>
+    void for_each_segment(Func&& func) const;
+
+    // copy all the elements into a contiguous cvector
+    template <typename OutAlloc, typename Growth>
+    void flatten(cvector<T, OutAlloc, Growth>& out) const;
+
+
+    // setters (thread-safe): return the index of the (first) new element;
+    // NOTE: the slots are reserved before the elements are constructed and can't be
+    //       given back to other threads, so a push which fails (a segment allocation
+    //       or an element constructor throws) terminates the program instead of
+    //       leaving unconstructed elements inside the vector
+    index push_back(const T& value) noexcept;
+    index push_back(T&& value) noexcept;
+    index grow_by(const vsize count, const T& value = T()) noexcept;
+
+    // NOT thread-safe
+    void  clear();
+
+private:
+    static constexpr vsize segment_base(const int seg) { return seg ? (FirstSegment << (seg - 1)) : 0; }
+    static constexpr vsize segment_size(const int seg) { return seg ? (FirstSegment << (seg - 1)) : FirstSegment; }
+
+    static constexpr int segment_of(const index i)
+    {
+        return (int)std::bit_width((size_t)i / (size_t)FirstSegment);
+    }
+
+    // get the segment (allocate it if it doesn't exist yet)
+    T* get_segment(const int seg) noexcept;
+
+    // construct the element by idx
+    template <typename... Args>
+    void construct_at(const index idx, Args&&... args);
+
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    std::atomic<T*>    segments_[maxSegments] = {};
+    std::atomic<vsize> size_{ 0 };
+    std::atomic_flag   allocLocks_[maxSegments] = {};    // a thread which allocates the segment
+
+    [[no_unique_address]] Alloc alloc_;
+};
+
+
+// =================================================================================
+//                                destructor
+// =================================================================================
+template <typename T, vsize FirstSegment, typename Alloc>
+concurrent_cvector<T, FirstSegment, Alloc>::~concurrent_cvector()
+{
+    clear();
+
+    for (int seg = 0; seg < maxSegments; ++seg)
+    {
+        T* data = segments_[seg].load(std::memory_order_relaxed);
+
+        if (data)
+            alloc_traits::deallocate(alloc_, data, (size_t)segment_size(seg));
+    }
+}
+
+
+// =================================================================================
+//                                  getters
+// =================================================================================
+template <typename T, vsize FirstSegment, typename Alloc>
+inline vsize concurrent_cvector<T, FirstSegment, Alloc>::capacity() const
+{
+    // segments are allocated in order (except the short moments of concurrent growth)
+    vsize cap = 0;
+
+    for (int seg = 0; (seg < maxSegments) && segments_[seg].load(std::memory_order_acquire); ++seg)
+        cap += segment_size(seg);
+
+    return cap;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize FirstSegment, typename Alloc>
+template <typename Func>
+void concurrent_cvector<T, FirstSegment, Alloc>::for_each_segment(Func&& func) const
+{
+    const vsize numElems = size();
+
+    for (int seg = 0; segment_base(seg) < numElems; ++seg)
+    {
+        const vsize count = std::min(segment_size(seg), numElems - segment_base(seg));
+        func((const T*)segments_[seg].load(std::memory_order_acquire), count);
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize FirstSegment, typename Alloc>
+template <typename OutAlloc, typename Growth>
+void concurrent_cvector<T, FirstSegment, Alloc>::flatten(cvector<T, OutAlloc, Growth>& out) const
+{
+    // a single allocation of the output and a copy of each segment
+
+    out.clear();
+
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        out.resize_default_init(size());
+        T* dst = out.begin();
+
+        for_each_segment([&dst](const T* data, const vsize count)
+        {
+            memcpy((void*)dst, data, count * sizeof(T));
+            dst += count;
+        });
+    }
+    else
+    {
+        out.reserve(size());
+
+        for_each_segment([&out](const T* data, const vsize count)
+        {
+            for (index i = 0; i < count; ++i)
+                out.push_back(data[i]);
+        });
+    }
+}
+
+
+// =================================================================================
+//                                  setters
+// =================================================================================
+template <typename T, vsize FirstSegment, typename Alloc>
+inline index concurrent_cvector<T, FirstSegment, Alloc>::push_back(const T& value) noexcept
+{
+    const index idx = size_.fetch_add(1, std::memory_order_acq_rel);
+    construct_at(idx, value);
+    return idx;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize FirstSegment, typename Alloc>
+inline index concurrent_cvector<T, FirstSegment, Alloc>::push_back(T&& value) noexcept
+{
+    const index idx = size_.fetch_add(1, std::memory_order_acq_rel);
+    construct_at(idx, std::move(value));
+    return idx;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize FirstSegment, typename Alloc>
+index concurrent_cvector<T, FirstSegment, Alloc>::grow_by(const vsize count, const T& value) noexcept
+{
+    // reserve a range of [first, first+count) with a single atomic add
+    // and construct the elements segment by segment
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if (count < 0)
+        {
+            cvector_io::print_error("concurrent_cvector::grow_by()", "invalid input args");
+            return -1;
+        }
+    }
+
+    const index first = size_.fetch_add(count, std::memory_order_acq_rel);
+    const index last  = first + count;
+
+    for (index i = first; i < last; )
+    {
+        const int   seg  = segment_of(i);
+        T*          data = get_segment(seg);
+        const index end  = std::min(last, segment_base(seg) + segment_size(seg));
+
+        std::uninitialized_fill(data + (i - segment_base(seg)), data + (end - segment_base(seg)), value);
+        i = end;
+    }
+
+    return first;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize FirstSegment, typename Alloc>
+void concurrent_cvector<T, FirstSegment, Alloc>::clear()
+{
+    // destroy all the elements but keep the segments
+
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        for_each_segment([](const T* data, const vsize count)
+        {
+            std::destroy_n((T*)data, count);
+        });
+    }
+
+    size_.store(0, std::memory_order_release);
+}
+
+
+// =================================================================================
+//                              private methods
+// =================================================================================
+template <typename T, vsize FirstSegment, typename Alloc>
+T* concurrent_cvector<T, FirstSegment, Alloc>::get_segment(const int seg) noexcept
+{
+    T* data = segments_[seg].load(std::memory_order_acquire);
+
+    if (data)
+        return data;
+
+    // the first thread allocates the segment, the others wait for it
+    if (!allocLocks_[seg].test_and_set(std::memory_order_acq_rel))
+    {
+        try
+        {
+            data = alloc_traits::allocate(alloc_, (size_t)segment_size(seg));
+        }
+        catch (const std::bad_alloc& e)
+        {
+            // the slots of this segment are already reserved by other threads
+            cvector_io::print_error("concurrent_cvector::get_segment()", e.what());
+            fflush(stdout);
+            std::abort();
+        }
+
+        segments_[seg].store(data, std::memory_order_release);
+        return data;
+    }
+
+    while (!(data = segments_[seg].load(std::memory_order_acquire)))
+        std::this_thread::yield();
+
+    return data;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize FirstSegment, typename Alloc>
+template <typename... Args>
+inline void concurrent_cvector<T, FirstSegment, Alloc>::construct_at(const index idx, Args&&... args)
+{
+    const int seg  = segment_of(idx);
+    T*        data = get_segment(seg);
+
+    new (data + (idx - segment_base(seg))) T(std::forward<Args>(args)...);
+}
@@ -7,9 +7,34 @@
 // =================================================================================
 #pragma once
 
+// glibc declares the legacy index() function in <strings.h> (which is pulled in
+// by <cstring>), it clashes with the global index typedef below so hide it;
+// NOTE: on such platforms include cvector.h before other headers
+#if !defined(_MSC_VER) && defined(__has_include)
+    #if __has_include(<strings.h>)
+        #define index cvector_strings_index_
+        #include <strings.h>
+        #undef index
+    #endif
+#endif
+
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 #include <stdarg.h>
 
+#include "cvector_growth.h"
+#include "cvector_search.h"
+#include "cvector_serialize.h"
+#include "cvector_simd.h"
+#include "cvector_telemetry.h"
+
 // this macro is used for the vassert() method
 #define CALLER_INFO "  FILE: \t%s\n  CLASS:\t%s\n  FUNC: \t%s()\n  LINE: \t%d\n  MSG: \t\t%s\n", __FILE__, typeid(this).name(), __func__, __LINE__
 
@@ -17,86 +42,239 @@
 constexpr bool ENABLE_CHECK = true;
 
 
+// error output for non-member code (cvector::error_msg() is used inside the class)
+namespace cvector_io
+{
+
+inline void print_error(const char* source, const char* msg)
+{
+    // source -- path of the file or name of the function
+
+    const char* consoleRed  = "\x1B[31m";
+    const char* consoleNorm = "\x1B[0m";
+
+    printf("%s\nERROR:\n  SOURCE:\t%s\n  MSG: \t\t%s\n%s", consoleRed, source ? source : "(null)", msg, consoleNorm);
+}
+
+} // namespace cvector_io
+
+
 // some typedefas
 using index = ptrdiff_t;
 using vsize = ptrdiff_t;
-static float growFactor_ = 1.5f;
+
+
+// =================================================================================
+// RELOCATION TRAIT
+// 
+// if a type is trivially relocatable we can move its objects into another
+// place in memory using memcpy()/memmove() and just "forget" the old bytes
+// (without calling move-constructor + destructor for each element);
+// 
+// by default these are all trivially copyable types; you can opt-in your own
+// types which are known to be bitwise relocatable (handles, unique_ptr-like types,
+// MSVC std::string, etc.) by specialization:
+//
+//     template<> struct is_trivially_relocatable<MyHandle> : std::true_type {};
+// 
+// NOTE: libstdc++ std::string is NOT bitwise relocatable (SSO buffer pointer)
+// =================================================================================
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+
+// =================================================================================
+// QUERY ORDER
+//
+// hint for batched sorted lookups (get_idxs, get_insert_idxs, binary_search with
+// output flags): if query values are sorted as well, each search resumes from
+// the previous hit using galloping (exponential) search, so the whole batch is
+// processed in a single streaming pass instead of k independent binary searches
+//
+// unknown  -- check the input values (O(k)) and choose the algorithm
+// sorted   -- trust the caller: values are sorted
+// unsorted -- don't check, use independent binary searches
+// =================================================================================
+enum class query_order
+{
+    unknown,
+    sorted,
+    unsorted
+};
+
+
+// packed boolean flags (see cvector_bits.h)
+class cvector_bits;
+
+// execution policies of the batched methods: cvector_execution.h specializes
+// the trait for its policies and defines the policy overloads of cvector
+namespace cvector_exec
+{
+
+template <typename T>
+constexpr bool is_execution_policy_v = false;
+
+template <typename T>
+concept execution_policy = is_execution_policy_v<std::remove_cvref_t<T>>;
+
+} // namespace cvector_exec
 
 
 // =================================================================================
 // CVECTOR
+// 
+// Alloc  -- allocator which is used for the elements storage (std::allocator by default);
+//           it can be stateful (see cvector_allocators.h for arena/pool/frame allocators)
+//           or std::pmr::polymorphic_allocator (see pmr_cvector)
+// Growth -- growth policy: how much capacity is allocated when the vector runs
+//           out of it (see cvector_growth.h)
 // =================================================================================
-template<typename T>
+template<typename T, typename Alloc = std::allocator<T>, typename Growth = default_growth>
 class cvector
 {
+    static_assert(cvector_growth::growth_policy<Growth>, "cvector: Growth must have static grow(capacity, required, elemSize)");
+
+public:
+    using allocator_type = Alloc;
+    using growth_policy  = Growth;
+
+    // call site of reserve/push_back/resize for the allocation telemetry
+    // (an empty struct if telemetry is off, see cvector_telemetry.h)
+    using call_site = cvector_telemetry::call_site;
+
 private:
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    template <typename, typename, typename>
+    friend class cvector;
+
+    template <typename, vsize, typename>
+    friend class small_cvector;
+
+    template <typename, vsize>
+    friend class frozen_cvector;
+
+    template <typename>
+    friend class cvector_view;
+
+    template <typename>
+    friend class cvector_span;
+
+    template <typename, int, typename>
+    friend class segmented_cvector;
+
     T* data_ = nullptr;
     vsize size_ = 0;
     vsize capacity_ = 0;
+    [[no_unique_address]] Alloc alloc_;
+    [[no_unique_address]] call_site allocSite_;    // where the buffer was allocated (for telemetry)
 
 public:
-    cvector();
-    cvector(const vsize count, const T& value = T());
+    constexpr cvector();
+    explicit cvector(const Alloc& alloc);
+    cvector(const vsize count, const T& value = T(), const Alloc& alloc = Alloc());
 
-    cvector(const cvector<T>& other);
-    cvector(cvector<T>&& other) noexcept;
+    cvector(const cvector<T, Alloc, Growth>& other);
+    constexpr cvector(cvector<T, Alloc, Growth>&& other) noexcept;
 
-    cvector(std::initializer_list<T> il);
+    constexpr cvector(std::initializer_list<T> il, const Alloc& alloc = Alloc());
 
     template<typename Iter>
-    inline cvector(const Iter* first, const Iter* last) { assign(first, last); }
+    inline cvector(const Iter* first, const Iter* last, const Alloc& alloc = Alloc()) : alloc_(alloc) { assign(first, last); }
 
-    ~cvector();
+    constexpr ~cvector();
 
 
     // operators
-    inline       T& operator[](index i) { return data_[i]; }    // v[i] = x
-    inline const T& operator[](index i) const { return data_[i]; }    // x = v[i]
+    constexpr       T& operator[](index i) { return data_[i]; }    // v[i] = x
+    constexpr const T& operator[](index i) const { return data_[i]; }    // x = v[i]
 
-    bool        operator==(const cvector<T>& rhs) const;
-    cvector<T>& operator=(const cvector<T>& rhs);
-    cvector<T>& operator=(cvector<T>&& rhs) noexcept;
-    cvector<T>& operator=(std::initializer_list<T> list);
+    bool               operator==(const cvector<T, Alloc, Growth>& rhs) const;
+    cvector<T, Alloc, Growth>& operator=(const cvector<T, Alloc, Growth>& rhs);
+    cvector<T, Alloc, Growth>& operator=(cvector<T, Alloc, Growth>&& rhs) noexcept;
+    cvector<T, Alloc, Growth>& operator=(std::initializer_list<T> list);
 
 
     // iterators
-    inline T*       begin()                       { return data_; }
-    inline const T* begin()                 const { return data_; }
-    inline T*       end()                         { return data_ + size_; }
-    inline const T* end()                   const { return data_ + size_; }
+    constexpr T*       begin()                    { return data_; }
+    constexpr const T* begin()              const { return data_; }
+    constexpr T*       end()                      { return data_ + size_; }
+    constexpr const T* end()                const { return data_ + size_; }
 
 
     // getters
-    inline const T* data()                  const { return data_; }
-    inline bool     empty()                 const { return size_ == 0; }
-    inline vsize    size()                  const { return size_; }
-    inline vsize    capacity()              const { return capacity_; }
-    inline bool     is_valid_index(index i) const { return (i >= 0) && (i < size_); };
+    constexpr T*       data()                        { return data_; }
+    constexpr const T* data()                  const { return data_; }
+    constexpr bool     empty()                 const { return size_ == 0; }
+    constexpr vsize    size()                  const { return size_; }
+    constexpr vsize    capacity()              const { return capacity_; }
+    constexpr bool     is_valid_index(index i) const { return (i >= 0) && (i < size_); };
+    inline Alloc    get_allocator()         const { return alloc_; }
+
+    template <typename IdxAlloc, typename OutAlloc>
+    void get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, cvector<T, OutAlloc>& outData) const;
 
-    void get_data_by_idxs(const cvector<index>& idxs, cvector<T>& outData) const;
-    void get_data_by_idxs(const cvector<index>& idxs, T* outData) const;
+    template <typename IdxAlloc>
+    void get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, T* outData) const;
 
     // setters
-    void         push_back(const T& value);
-    inline void  pop_back() { if (size_ > 0) size_--; }
-    inline void  clear() { size_ = 0; };
+    constexpr void push_back(const T& value, const call_site site = call_site::current());
+    constexpr void pop_back();
+    constexpr void clear();
 
     void         shrink_to_fit();
     void         purge();
     void         erase(const vsize index);
-    inline void  assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); };
+
+    // batched erase in a single pass (return the number of erased elements)
+    vsize        erase_idxs(const index* sortedIdxs, const vsize numIdxs);
+    vsize        erase_values(const T* sortedValues, const vsize numValues);
+    vsize        erase_values(const cvector<T, Alloc, Growth>& sortedValues);
+
+    template <typename IdxAlloc>
+    inline vsize erase_idxs(const cvector<index, IdxAlloc>& sortedIdxs) { return erase_idxs(sortedIdxs.data(), sortedIdxs.size()); }
+
+    template <typename Pred>
+    vsize        erase_if(Pred pred);
+    constexpr void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); };
 
     // get index(or indices) for sorted insertion / insertion
     index get_insert_idx(const ptrdiff_t& value) const;
-    void  get_insert_idxs(const cvector<T>& values, cvector<index>& idxs) const;
-    void  get_insert_idxs(const T* values, const vsize numValues, cvector<index>& idxs) const;
+
+    template <typename IdxAlloc>
+    void  get_insert_idxs(
+        const cvector<T, Alloc, Growth>& values,
+        cvector<index, IdxAlloc>& idxs,
+        const query_order order = query_order::unknown) const;
+
+    template <typename IdxAlloc>
+    void  get_insert_idxs(
+        const T* values,
+        const vsize numValues,
+        cvector<index, IdxAlloc>& idxs,
+        const query_order order = query_order::unknown) const;
+
     void  insert_before(const vsize idx, const T& val);
 
+    // sorted insertion of a batch of SORTED values in a single pass
+    void  insert_sorted(const T* values, const vsize numValues);
+    void  insert_sorted(const cvector<T, Alloc, Growth>& values);
+
+    // ... the same (out: final indices of inserted values)
+    template <typename IdxAlloc>
+    void  insert_sorted(const T* values, const vsize numValues, cvector<index, IdxAlloc>& outIdxs);
+
+    template <typename IdxAlloc>
+    void  insert_sorted(const cvector<T, Alloc, Growth>& values, cvector<index, IdxAlloc>& outIdxs);
+
     template <typename U>
     void append_vector(U&& src);
 
     template<typename Iter>
-    void assign(Iter first, Iter last);
+    constexpr void assign(Iter first, Iter last);
 
 
     // shift elements
@@ -106,21 +284,100 @@ public:
 
     // search
     index find(const T& value) const;
-    index get_idx(const T& value) const;
-    void get_idxs(const T* values, const vsize numElems, cvector<index>& outIdxs) const;
-    void get_idxs(const cvector<T>& values, cvector<index>& outIdxs) const;
+    index find_any(const T* values, const vsize numValues) const;
+    constexpr index get_idx(const T& value) const;
+
+    template <typename IdxAlloc>
+    void get_idxs(
+        const T* values,
+        const vsize numElems,
+        cvector<index, IdxAlloc>& outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    template <typename IdxAlloc>
+    void get_idxs(
+        const cvector<T, Alloc, Growth>& values,
+        cvector<index, IdxAlloc>& outIdxs,
+        const query_order order = query_order::unknown) const;
 
     bool has_value(const T& val) const;
-    bool binary_search(const T& value) const;
-    bool binary_search(const cvector<T>& vSrc) const;
+    constexpr bool binary_search(const T& value) const;
+    bool binary_search(const cvector<T, Alloc, Growth>& vSrc) const;
     bool binary_search(const T* values, const vsize numElems) const;
-    void binary_search(const T* values, vsize numElems, cvector<bool>& flags) const;
+
+    template <typename FlagAlloc>
+    void binary_search(
+        const T* values,
+        vsize numElems,
+        cvector<bool, FlagAlloc>& flags,
+        const query_order order = query_order::unknown) const;
+
+    // packed flags (64 per word), defined in cvector_bits.h
+    void binary_search(
+        const T* values,
+        vsize numElems,
+        cvector_bits& flags,
+        const query_order order = query_order::unknown) const;
+
+
+    // batched methods with an execution policy, defined in cvector_execution.h:
+    // cvector_exec::seq, cvector_exec::par, cvector_exec::par_unseq
+    template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+    void get_idxs(
+        Policy&& policy,
+        const T* values,
+        const vsize numElems,
+        cvector<index, IdxAlloc>& outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+    void get_idxs(
+        Policy&& policy,
+        const cvector<T, Alloc, Growth>& values,
+        cvector<index, IdxAlloc>& outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+    void get_insert_idxs(
+        Policy&& policy,
+        const T* values,
+        const vsize numValues,
+        cvector<index, IdxAlloc>& idxs,
+        const query_order order = query_order::unknown) const;
+
+    template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+    void get_insert_idxs(
+        Policy&& policy,
+        const cvector<T, Alloc, Growth>& values,
+        cvector<index, IdxAlloc>& idxs,
+        const query_order order = query_order::unknown) const;
+
+    template <cvector_exec::execution_policy Policy, typename FlagAlloc>
+    void binary_search(
+        Policy&& policy,
+        const T* values,
+        vsize numElems,
+        cvector<bool, FlagAlloc>& flags,
+        const query_order order = query_order::unknown) const;
+
+    template <cvector_exec::execution_policy Policy, typename IdxAlloc, typename OutAlloc>
+    void get_data_by_idxs(Policy&& policy, const cvector<index, IdxAlloc>& idxs, cvector<T, OutAlloc>& outData) const;
+
+    template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+    void get_data_by_idxs(Policy&& policy, const cvector<index, IdxAlloc>& idxs, T* outData) const;
 
 
     // allocators
-    void reserve(const vsize newCapacity);
-    void resize(const vsize newSize);
-    void resize(const vsize newSize, const T& value);
+    constexpr void reserve(const vsize newCapacity, const call_site site = call_site::current());
+    void resize(const vsize newSize, const call_site site = call_site::current());
+    void resize(const vsize newSize, const T& value, const call_site site = call_site::current());
+    void resize_default_init(const vsize newSize);
+
+
+    // binary serialization of trivially copyable elements (see cvector_serialize.h);
+    // a saved file can be also mapped into memory with cvector_view<T>
+    bool save(const char* path) const requires std::is_trivially_copyable_v<T>;
+    bool load(const char* path)       requires std::is_trivially_copyable_v<T>;
 
 private:
     void vassert(
@@ -141,26 +398,105 @@ private:
         const int line) const;
 
 
-    void realloc_buffer_discard(const vsize newCapacity);
-    void realloc_buffer(const vsize newCapacity);
+    void realloc_buffer_discard(const vsize newCapacity, const call_site site = call_site::current());
+    constexpr void realloc_buffer(const vsize capacity, const call_site site = call_site::current());
+
+    // raw storage: memory is allocated/released (using the allocator) without
+    // constructing/destroying any object, only elements in range [0, size_) are alive
+    constexpr T*          alloc_raw(const vsize count);
+    constexpr T*          alloc_raw_at_least(vsize& count);
+    constexpr void        free_raw(T* ptr, const vsize count);
+    static constexpr void destroy_range(T* first, T* last);
+
+    // can shift_right()/shift_left() relocate elements using memmove:
+    // vacated positions of non-trivial types are refilled with T()
+    static constexpr bool can_shift_bitwise()
+    {
+        return is_trivially_relocatable_v<T> &&
+               (std::is_trivially_copyable_v<T> || std::is_default_constructible_v<T>);
+    }
+
+    // can realloc_buffer() resize the buffer with the allocator (mremap/realloc):
+    // the elements are relocated bitwise by the allocator
+    static constexpr bool can_realloc_in_place()
+    {
+        return is_trivially_relocatable_v<T> &&
+               requires(Alloc& a, T* ptr, size_t n) { a.reallocate_at_least(ptr, n, n); };
+    }
+
+    // search in sorted range [first, last): for arithmetic types the branchless
+    // prefetching binary search is used, for the rest -- std algorithms
+    template <typename U>
+    static constexpr const T* lower_bound_ptr(const T* first, const T* last, const U& value);
 
-    inline void safe_delete() { if (data_) { delete[] data_; data_ = nullptr; } }
+    template <typename U>
+    static constexpr const T* upper_bound_ptr(const T* first, const T* last, const U& value);
 
-    inline vsize GetGrownCapacity(const vsize capacity)
+    template <typename U>
+    static constexpr bool     binary_search_ptr(const T* first, const T* last, const U& value);
+
+    // exponential search of the lower (or upper) bound starting from the first:
+    // costs O(log d) where d is a distance from the first to the bound
+    template <bool IsUpper, typename U>
+    static const T* gallop_bound_ptr(const T* first, const T* last, const U& value);
+
+    // are query values sorted (values are checked if the order is unknown)
+    static bool is_sorted_batch(const T* values, const vsize numValues, const query_order order);
+
+    // get the lower (or upper) bound idx in sorted range [b, e) for each input value
+    template <bool IsUpper>
+    static void get_bound_idxs(
+        const T* b,
+        const T* e,
+        const T* values,
+        const vsize numValues,
+        index* outIdxs,
+        const query_order order);
+
+    void insert_sorted_impl(const T* values, const vsize numValues, index* outIdxs);
+
+    // existence flags in sorted range [b, e) for values in range [first, last)
+    // of the batch (see binary_search())
+    static void search_flags(
+        const T* b,
+        const T* e,
+        const T* values,
+        const index first,
+        const index last,
+        bool* flags,
+        const bool isSorted);
+
+    // out[i] = src[idxs[i]] for i in [0, numIdxs)
+    static void gather_idxs(const T* src, const index* idxs, const vsize numIdxs, T* outData);
+
+    // remove sorted non-overlapping ranges [first, last) which are returned
+    // one by one by getNextRange(from, first, last) (returns false when there are
+    // no more ranges), the kept elements are moved left in a single pass
+    template <typename RangeFunc>
+    vsize erase_ranges(RangeFunc&& getNextRange);
+
+    constexpr void safe_delete();
+
+    constexpr vsize GetGrownCapacity(const vsize required) const
     {
-        // compute grown capacity: newCapacity = growFactor * capacity;
-        return (vsize)(ceil(growFactor_ * capacity));
+        // compute grown capacity (>= required) according to the growth policy
+        return (vsize)Growth::grow(capacity_, required, sizeof(T));
     }
 };
 
 
+// cvector which uses a std::pmr::memory_resource for its storage
+template <typename T>
+using pmr_cvector = cvector<T, std::pmr::polymorphic_allocator<T>>;
+
+
 
 
 // =================================================================================
 //                          constructor, destructor
 // =================================================================================
-template <typename T>
-inline cvector<T>::cvector() :
+template <typename T, typename Alloc, typename Growth>
+constexpr cvector<T, Alloc, Growth>::cvector() :
     size_(0),
     capacity_(0),
     data_(nullptr)
@@ -169,53 +505,79 @@ inline cvector<T>::cvector() :
 
 // ----------------------------------------------------
 
-template <typename T>
-inline cvector<T>::cvector(const vsize count, const T& value) :
+template <typename T, typename Alloc, typename Growth>
+inline cvector<T, Alloc, Growth>::cvector(const Alloc& alloc) :
+    alloc_(alloc)
+{
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+inline cvector<T, Alloc, Growth>::cvector(const vsize count, const T& value, const Alloc& alloc) :
     size_(count),
-    capacity_(count)
+    capacity_(count),
+    alloc_(alloc)
 {
-    data_ = new T[capacity_];                               // alloc memory
+    data_ = alloc_raw(capacity_);                           // alloc raw memory
+
+    if constexpr (cvector_telemetry::ENABLE_TELEMETRY)
+    {
+        allocSite_ = call_site::current();
+        cvector_telemetry::on_alloc<T>(allocSite_, 0, capacity_, 0);
+    }
 
-    for (vsize i = 0; i < size_; ++i)
-        data_[i] = value;                                   // init each element
+    // construct each element right in place
+    std::uninitialized_fill_n(data_, size_, value);
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline cvector<T>::cvector(const cvector<T>& other) :
+template <typename T, typename Alloc, typename Growth>
+inline cvector<T, Alloc, Growth>::cvector(const cvector<T, Alloc, Growth>& other) :
     size_(other.size_),
-    capacity_(other.capacity_)
+    capacity_(other.capacity_),
+    alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_))
 {
-    data_ = new T[capacity_];
+    data_ = alloc_raw(capacity_);
+
+    if constexpr (cvector_telemetry::ENABLE_TELEMETRY)
+    {
+        allocSite_ = call_site::current();
+        cvector_telemetry::on_alloc<T>(allocSite_, 0, capacity_, 0);
+    }
 
-    for (vsize i = 0; i < size_; ++i)
-        data_[i] = other.data_[i];
+    // construct only live elements, the rest of buffer remains raw memory
+    std::uninitialized_copy_n(other.data_, size_, data_);
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline cvector<T>::cvector(cvector<T>&& other) noexcept :
+template <typename T, typename Alloc, typename Growth>
+constexpr cvector<T, Alloc, Growth>::cvector(cvector<T, Alloc, Growth>&& other) noexcept :
     data_(std::exchange(other.data_, nullptr)),
     size_(std::exchange(other.size_, 0)),
-    capacity_(std::exchange(other.capacity_, 0))
+    capacity_(std::exchange(other.capacity_, 0)),
+    alloc_(std::move(other.alloc_)),
+    allocSite_(other.allocSite_)
 {
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline cvector<T>::cvector(std::initializer_list<T> il) : cvector()
+template <typename T, typename Alloc, typename Growth>
+constexpr cvector<T, Alloc, Growth>::cvector(std::initializer_list<T> il, const Alloc& alloc) :
+    alloc_(alloc)
 {
     assign(il.begin(), il.end());
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-cvector<T>::~cvector()
+template <typename T, typename Alloc, typename Growth>
+constexpr cvector<T, Alloc, Growth>::~cvector()
 {
+    destroy_range(data_, data_ + size_);
     safe_delete();
     size_ = 0;
     capacity_ = 0;
@@ -223,8 +585,8 @@ cvector<T>::~cvector()
 
 // ----------------------------------------------------
 
-template <typename T>
-bool cvector<T>::operator==(const cvector<T>& rhs) const
+template <typename T, typename Alloc, typename Growth>
+bool cvector<T, Alloc, Growth>::operator==(const cvector<T, Alloc, Growth>& rhs) const
 {
     // check if sizes are equal
     if (this->size() != rhs.size())
@@ -242,22 +604,35 @@ bool cvector<T>::operator==(const cvector<T>& rhs) const
 // =================================================================================
 //                  assignment: copy, move, initializer_list
 // =================================================================================
-template <typename T>
-inline cvector<T>& cvector<T>::operator=(const cvector<T>& rhs)
+template <typename T, typename Alloc, typename Growth>
+inline cvector<T, Alloc, Growth>& cvector<T, Alloc, Growth>::operator=(const cvector<T, Alloc, Growth>& rhs)
 {
     // copy assignment operator
 
     if (this == &rhs) return *this;
 
+    // if the allocator must be copied as well: the current memory
+    // must be released by the allocator which allocated it
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+    {
+        if (alloc_ != rhs.alloc_)
+            purge();
+
+        alloc_ = rhs.alloc_;
+    }
+
     // realloc memory if need
     if (capacity_ < rhs.size_)
     {
         realloc_buffer_discard(rhs.size_);
     }
 
-    // copy the data
-    for (vsize i = 0; i < rhs.size_; ++i)
-        data_[i] = rhs.data_[i];
+    // assign over alive elements, construct the rest, destroy redundant
+    const vsize numAssign = std::min(size_, rhs.size_);
+
+    std::copy_n(rhs.data_, numAssign, data_);
+    std::uninitialized_copy(rhs.data_ + numAssign, rhs.data_ + rhs.size_, data_ + numAssign);
+    destroy_range(data_ + rhs.size_, data_ + size_);
 
     size_ = rhs.size_;
 
@@ -266,24 +641,50 @@ inline cvector<T>& cvector<T>::operator=(const cvector<T>& rhs)
 
 // ----------------------------------------------------
 
-template <typename T>
-inline cvector<T>& cvector<T>::operator=(cvector<T>&& rhs) noexcept
+template <typename T, typename Alloc, typename Growth>
+inline cvector<T, Alloc, Growth>& cvector<T, Alloc, Growth>::operator=(cvector<T, Alloc, Growth>&& rhs) noexcept
 {
     if (this == &rhs) return *this;
 
+    constexpr bool canSteal =
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value;
+
+    // we can't steal a buffer which was allocated by another (non-equal) allocator
+    // so just move the elements one by one
+    if constexpr (!canSteal)
+    {
+        if (alloc_ != rhs.alloc_)
+        {
+            clear();
+            reserve(rhs.size_);
+
+            std::uninitialized_move(rhs.data_, rhs.data_ + rhs.size_, data_);
+            size_ = rhs.size_;
+
+            rhs.purge();
+            return *this;
+        }
+    }
+
+    destroy_range(data_, data_ + size_);
     safe_delete();
 
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+        alloc_ = std::move(rhs.alloc_);
+
     data_ = std::exchange(rhs.data_, nullptr);
     size_ = std::exchange(rhs.size_, 0);
     capacity_ = std::exchange(rhs.capacity_, 0);
+    allocSite_ = rhs.allocSite_;
 
     return *this;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-cvector<T>& cvector<T>::operator=(std::initializer_list<T> list)
+template <typename T, typename Alloc, typename Growth>
+cvector<T, Alloc, Growth>& cvector<T, Alloc, Growth>::operator=(std::initializer_list<T> list)
 {
     const vsize listSize = list.size();
 
@@ -293,11 +694,14 @@ cvector<T>& cvector<T>::operator=(std::initializer_list<T> list)
         realloc_buffer_discard(listSize);
     }
 
-    size_ = listSize;
+    // assign over alive elements, construct the rest, destroy redundant
+    const vsize numAssign = std::min(size_, listSize);
 
-    // copy elems from the list
-    for (vsize i = 0; const T & elem : list)
-        data_[i++] = elem;
+    std::copy_n(list.begin(), numAssign, data_);
+    std::uninitialized_copy(list.begin() + numAssign, list.end(), data_ + numAssign);
+    destroy_range(data_ + listSize, data_ + size_);
+
+    size_ = listSize;
 
     return *this;
 }
@@ -306,46 +710,74 @@ cvector<T>& cvector<T>::operator=(std::initializer_list<T> list)
 // =================================================================================
 //                           get data by indices
 // =================================================================================
-template <typename T>
-inline void cvector<T>::get_data_by_idxs(
-    const cvector<index>& idxs,
-    cvector<T>& outData) const
+template <typename T, typename Alloc, typename Growth>
+template <typename IdxAlloc, typename OutAlloc>
+inline void cvector<T, Alloc, Growth>::get_data_by_idxs(
+    const cvector<index, IdxAlloc>& idxs,
+    cvector<T, OutAlloc>& outData) const
 {
     // out:  array of data elements by input indices
 
-    outData.resize(idxs.size());
+    // elements are overwritten anyway so don't value-initialize them
+    if constexpr (cvector_simd::is_bytewise_copyable_v<T>)
+        outData.resize_default_init(idxs.size());
+    else
+        outData.resize(idxs.size());
 
-    for (int i = 0; index idx : idxs)
-        outData[i++] = data_[idx];
+    get_data_by_idxs(idxs, outData.begin());
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-void cvector<T>::get_data_by_idxs(const cvector<index>& idxs, T* outData) const
+template <typename T, typename Alloc, typename Growth>
+template <typename IdxAlloc>
+void cvector<T, Alloc, Growth>::get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, T* outData) const
 {
     // out:  array of data elements by input indices
     // NOTE: it is supposed that idxs.size() == outData.size()
 
     if constexpr (ENABLE_CHECK)
     {
-        if (outData == nullptr)
+        if ((outData == nullptr) && !idxs.empty())
         {
             error_msg("invalid input args", CALLER_INFO);
             return;
         }
     }
 
-    for (int i = 0; index idx : idxs)
-        outData[i++] = data_[idx];
+    gather_idxs(data_, idxs.data(), idxs.size(), outData);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::gather_idxs(const T* src, const index* idxs, const vsize numIdxs, T* outData)
+{
+    // trivially copyable: memcpy for runs of consecutive idxs, AVX2 gather, prefetching
+    if constexpr (cvector_simd::is_bytewise_copyable_v<T>)
+    {
+        cvector_simd::gather(src, idxs, numIdxs, outData);
+    }
+    else
+    {
+        constexpr vsize dist = cvector_simd::gatherPrefetchDistance;
+
+        for (vsize i = 0; i < numIdxs; ++i)
+        {
+            if (i + dist < numIdxs)
+                cvector_simd::prefetch_elem(src + idxs[i + dist]);
+
+            outData[i] = src[idxs[i]];
+        }
+    }
 }
 
 
 // =================================================================================
 //                               shift elements
 // =================================================================================
-template <typename T>
-void cvector<T>::shift_right(const index idx, const int num)
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::shift_right(const index idx, const int num)
 {
     // shift right all the elements of range [idx, end) by the num positions;
     // idx - start index of the original range
@@ -360,13 +792,21 @@ void cvector<T>::shift_right(const index idx, const int num)
         }
     }
 
-    // if our type is POD, or plain structure we use memmove
-    if constexpr (std::is_standard_layout_v<T>)
+    // if our type is relocatable we use memmove
+    if constexpr (can_shift_bitwise())
     {
-        index numToMove = size_ - idx - num;
+        const index numToMove = size_ - idx - num;
 
-        if ((numToMove > 0))
-            memmove(&data_[idx + num], &data_[idx], numToMove * sizeof(T));
+        if (numToMove > 0)
+        {
+            // elements at the tail are overwritten so destroy them first
+            destroy_range(data_ + size_ - num, data_ + size_);
+            memmove((void*)&data_[idx + num], &data_[idx], numToMove * sizeof(T));
+
+            // vacated positions hold stale bytes: make them valid (moved-from) objects
+            if constexpr (!std::is_trivially_copyable_v<T>)
+                std::uninitialized_value_construct(data_ + idx, data_ + idx + num);
+        }
     }
     // we have some complex data type
     else
@@ -377,8 +817,8 @@ void cvector<T>::shift_right(const index idx, const int num)
 
 // ----------------------------------------------------
 
-template <typename T>
-inline void cvector<T>::shift_left(const index idx, const int num)
+template <typename T, typename Alloc, typename Growth>
+inline void cvector<T, Alloc, Growth>::shift_left(const index idx, const int num)
 {
     // shift left all the elements of range [idx, end) by the num positions;
     // idx - start index of the original range
@@ -392,228 +832,683 @@ inline void cvector<T>::shift_left(const index idx, const int num)
             return;
         }
     }
-  
-    std::shift_left(begin() + idx, end(), num);
+
+    // if our type is relocatable we use memmove
+    if constexpr (can_shift_bitwise())
+    {
+        const index numToMove = size_ - idx - num;
+
+        if (numToMove > 0)
+        {
+            // elements at the head of range are overwritten so destroy them first
+            destroy_range(data_ + idx, data_ + idx + num);
+            memmove((void*)&data_[idx], &data_[idx + num], numToMove * sizeof(T));
+
+            // vacated positions hold stale bytes: make them valid (moved-from) objects
+            if constexpr (!std::is_trivially_copyable_v<T>)
+                std::uninitialized_value_construct(data_ + size_ - num, data_ + size_);
+        }
+    }
+    // we have some complex data type
+    else
+    {
+        std::shift_left(begin() + idx, end(), num);
+    }
 }
 
 
 // =================================================================================                                                                                                              
 //                               public setters
 // =================================================================================
-template <typename T>
-inline void cvector<T>::push_back(const T& value)
+template <typename T, typename Alloc, typename Growth>
+constexpr void cvector<T, Alloc, Growth>::push_back(const T& value, const call_site site)
 {
     if (size_ == capacity_)
     {
-        // create a new array with growFactor times the original capacity
-        const vsize newCapacity = GetGrownCapacity(capacity_ ? capacity_ : 8);
-        reserve(newCapacity);
+        // create a new array with grown capacity
+        const vsize newCapacity = GetGrownCapacity(size_ + 1);
+        reserve(newCapacity, site);
     }
 
-    data_[size_] = value;
+    std::construct_at(data_ + size_, value);
     size_++;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline void cvector<T>::erase(const vsize index)
+template <typename T, typename Alloc, typename Growth>
+constexpr void cvector<T, Alloc, Growth>::pop_back()
 {
-    if constexpr (ENABLE_CHECK)
+    if (size_ > 0)
     {
-        if ((index < 0) | (index >= size_))
-        {
-            error_msg("invalid input args", CALLER_INFO);
-            return;
-        }
+        size_--;
+        std::destroy_at(&data_[size_]);
     }
-
-    for (vsize i = index; i < size_ - 1; ++i)
-        data_[i] = std::move(data_[i + 1]);
-
-    size_--;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-index cvector<T>::get_insert_idx(const ptrdiff_t& value) const
+template <typename T, typename Alloc, typename Growth>
+constexpr void cvector<T, Alloc, Growth>::clear()
 {
-    // get position (index) into array for sorted INSERTION;
-    // is used together with insert_before() method
-
-    return std::distance(begin(), std::upper_bound(begin(), end(), value));
+    // destroy all the elements but keep the capacity
+    destroy_range(data_, data_ + size_);
+    size_ = 0;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-void cvector<T>::get_insert_idxs(const cvector<T>& values, cvector<index>& idxs) const
+template <typename T, typename Alloc, typename Growth>
+inline void cvector<T, Alloc, Growth>::erase(const vsize index)
 {
-    // get positions (indices) into array for sorted INSERTION;
-    // is used together with insert_before() method
-
-    const vsize sz = values.size();
-    idxs.resize(sz);
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((index < 0) | (index >= size_))
+        {
+            error_msg("invalid input args", CALLER_INFO);
+            return;
+        }
+    }
 
-    const T* b = begin();
-    const T* e = end();
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        // destroy the element and relocate the tail left with a single memmove
+        std::destroy_at(&data_[index]);
+        memmove((void*)&data_[index], &data_[index + 1], (size_ - index - 1) * sizeof(T));
+        size_--;
+    }
+    else
+    {
+        for (vsize i = index; i < size_ - 1; ++i)
+            data_[i] = std::move(data_[i + 1]);
 
-    for (index i = 0; i < sz; ++i)
-        idxs[i] = std::distance(b, std::upper_bound(b, e, values[i]));
+        size_--;
+        std::destroy_at(&data_[size_]);
+    }
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-void cvector<T>::get_insert_idxs(
-    const T* values,
-    const vsize numValues,
-    cvector<index>& idxs) const
+template <typename T, typename Alloc, typename Growth>
+vsize cvector<T, Alloc, Growth>::erase_idxs(const index* sortedIdxs, const vsize numIdxs)
 {
-    // get positions (indices) into array for sorted INSERTION;
-    // is used together with insert_before() method
+    // NOTE: input idxs must be SORTED (duplicates are allowed)
+    // DESC: erase elements by idxs, consecutive idxs are erased as a single range
 
     if constexpr (ENABLE_CHECK)
     {
-        if ((values == nullptr) | (numValues < 0))
+        if ((numIdxs < 0) | ((sortedIdxs == nullptr) & (numIdxs > 0)))
         {
             error_msg("invalid input args", CALLER_INFO);
-            return;
+            return 0;
+        }
+
+        if ((numIdxs > 0) && ((sortedIdxs[0] < 0) | (sortedIdxs[numIdxs - 1] >= size_)))
+        {
+            error_msg("invalid input args: some idx is out of range", CALLER_INFO);
+            return 0;
+        }
+
+        if (!std::is_sorted(sortedIdxs, sortedIdxs + numIdxs))
+        {
+            error_msg("input idxs must be sorted", CALLER_INFO);
+            return 0;
         }
     }
 
-    const T* b = begin();
-    const T* e = end();
-    idxs.resize(numValues);
+    index k = 0;
 
-    for (index i = 0; i < numValues; ++i)
-        idxs[i] = std::distance(b, std::upper_bound(b, e, values[i]));
+    return erase_ranges([&](const index from, index& first, index& last)
+    {
+        // skip duplicates
+        while ((k < numIdxs) && (sortedIdxs[k] < from))
+            ++k;
+
+        if (k == numIdxs)
+            return false;
+
+        first = sortedIdxs[k];
+        last  = first + 1;
+
+        // extend the range while idxs are consecutive
+        while ((k < numIdxs) && (sortedIdxs[k] <= last))
+            last = sortedIdxs[k++] + 1;
+
+        return true;
+    });
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-void cvector<T>::insert_before(const vsize idx, const T& value)
+template <typename T, typename Alloc, typename Growth>
+vsize cvector<T, Alloc, Growth>::erase_values(const T* sortedValues, const vsize numValues)
 {
-    // insert input value before arr value by idx;
-    // so input value will be right at this idx and all the rest will shift right;
-    // (for instance insert 1 at idx 1: [0 2 3] becomes [0 1 2 3]
-
+    // NOTE: both (*this) cvector and input values must be SORTED!
+    // DESC: erase all the elements which are equal to any of input values;
+    //       each next value is searched from the previous hit (galloping search)
 
     if constexpr (ENABLE_CHECK)
     {
-        if ((idx < 0) | (idx > size_))
+        if ((numValues < 0) | ((sortedValues == nullptr) & (numValues > 0)))
         {
             error_msg("invalid input args", CALLER_INFO);
-            return;
+            return 0;
         }
     }
 
-    if (capacity_ <= size_)
+    index k = 0;
+
+    return erase_ranges([&](const index from, index& first, index& last)
     {
-        // create a new array with growFactor times the original capacity
-        const vsize newCapacity = GetGrownCapacity(capacity_ ? capacity_ : 8);
-        reserve(newCapacity);
-    }
+        const T* e = end();
 
-    // now we have one more element
-    size_++;
+        for (; k < numValues; ++k)
+        {
+            const T* lower = gallop_bound_ptr<false>(data_ + from, e, sortedValues[k]);
+
+            if ((lower == e) || (sortedValues[k] < *lower))
+                continue;
 
-    // prepare a place for the input element and set it by index
-    shift_right(idx, 1);
-    new (&data_[idx]) T(value);
+            first = lower - data_;
+            last  = gallop_bound_ptr<true>(lower, e, sortedValues[k]) - data_;
+            ++k;
+            return true;
+        }
+
+        return false;
+    });
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-template <typename U>
-void cvector<T>::append_vector(U&& src)
+template <typename T, typename Alloc, typename Growth>
+inline vsize cvector<T, Alloc, Growth>::erase_values(const cvector<T, Alloc, Growth>& sortedValues)
 {
-    // move or copy the input cvector at the end of 
-    // the current one (append one to another)
+    return erase_values(sortedValues.data(), sortedValues.size());
+}
 
-    const vsize base = size();
-    const vsize srcSize = src.size();
-    vsize newSize = base + srcSize;
+// ----------------------------------------------------
 
-    if (capacity_ < newSize)
+template <typename T, typename Alloc, typename Growth>
+template <typename Pred>
+vsize cvector<T, Alloc, Growth>::erase_if(Pred pred)
+{
+    // DESC: erase all the elements for which pred(elem) returns true
+    //       (the order of the rest is kept);
+    //       trivially copyable types are compacted branchless (or with SIMD)
+
+    const vsize oldSize = size_;
+
+    if constexpr (cvector_simd::is_bytewise_copyable_v<T>)
     {
-        // create a new array with growFactor times the original capacity
-        const vsize newCapacity = GetGrownCapacity(newSize);
-        reserve(newCapacity);
+        size_ = cvector_simd::remove_if(data_, size_, pred);
+    }
+    else
+    {
+        T* newEnd = std::remove_if(data_, data_ + size_, pred);
+        destroy_range(newEnd, data_ + size_);
+        size_ = newEnd - data_;
     }
 
-    // move or copy the elements
-    for (vsize i = 0; i < srcSize; ++i)
+    return oldSize - size_;
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename RangeFunc>
+vsize cvector<T, Alloc, Growth>::erase_ranges(RangeFunc&& getNextRange)
+{
+    index dst = 0;          // where to move the next kept element
+    index src = 0;          // the first element which isn't processed yet
+    index first = 0;
+    index last  = 0;
+
+    // until the first erased range dst == src so nothing is moved
+    while (getNextRange(src, first, last))
     {
-        if constexpr (std::is_rvalue_reference<U&&>::value)
+        if constexpr (is_trivially_relocatable_v<T>)
         {
-            data_[base + i] = std::move(src[i]);
+            // erased elements are destroyed and their place is just
+            // overwritten by relocated bytes of the kept ones
+            destroy_range(data_ + first, data_ + last);
+
+            if ((dst != src) && (first > src))
+                memmove((void*)&data_[dst], &data_[src], (first - src) * sizeof(T));
         }
         else
         {
-            data_[base + i] = src[i];
+            if (dst != src)
+                std::move(data_ + src, data_ + first, data_ + dst);
         }
+
+        dst += first - src;
+        src = last;
     }
 
-    // if this is an rvalue, destroy the source cvector
-    if constexpr (std::is_rvalue_reference<U&&>::value)
+    // move the tail
+    if constexpr (is_trivially_relocatable_v<T>)
     {
-        src.purge();
+        if ((dst != src) && (size_ > src))
+            memmove((void*)&data_[dst], &data_[src], (size_ - src) * sizeof(T));
+    }
+    else
+    {
+        if (dst != src)
+            std::move(data_ + src, data_ + size_, data_ + dst);
     }
 
-    size_ = newSize;
-}
+    dst += size_ - src;
+
+    // relocated elements are already "gone", the rest must be destroyed
+    if constexpr (!is_trivially_relocatable_v<T>)
+        destroy_range(data_ + dst, data_ + size_);
+
+    const vsize numErased = size_ - dst;
+    size_ = dst;
+
+    return numErased;
+}
 
 // ----------------------------------------------------
 
-template <typename T>
+template <typename T, typename Alloc, typename Growth>
+index cvector<T, Alloc, Growth>::get_insert_idx(const ptrdiff_t& value) const
+{
+    // get position (index) into array for sorted INSERTION;
+    // is used together with insert_before() method
+
+    return std::distance(begin(), upper_bound_ptr(begin(), end(), value));
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename IdxAlloc>
+void cvector<T, Alloc, Growth>::get_insert_idxs(
+    const cvector<T, Alloc, Growth>& values,
+    cvector<index, IdxAlloc>& idxs,
+    const query_order order) const
+{
+    // get positions (indices) into array for sorted INSERTION;
+    // is used together with insert_before() method
+
+    idxs.resize(values.size());
+    get_bound_idxs<true>(begin(), end(), values.data(), values.size(), idxs.begin(), order);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename IdxAlloc>
+void cvector<T, Alloc, Growth>::get_insert_idxs(
+    const T* values,
+    const vsize numValues,
+    cvector<index, IdxAlloc>& idxs,
+    const query_order order) const
+{
+    // get positions (indices) into array for sorted INSERTION;
+    // is used together with insert_before() method
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((values == nullptr) | (numValues < 0))
+        {
+            error_msg("invalid input args", CALLER_INFO);
+            return;
+        }
+    }
+
+    idxs.resize(numValues);
+    get_bound_idxs<true>(begin(), end(), values, numValues, idxs.begin(), order);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::insert_before(const vsize idx, const T& value)
+{
+    // insert input value before arr value by idx;
+    // so input value will be right at this idx and all the rest will shift right;
+    // (for instance insert 1 at idx 1: [0 2 3] becomes [0 1 2 3]
+
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((idx < 0) | (idx > size_))
+        {
+            error_msg("invalid input args", CALLER_INFO);
+            return;
+        }
+    }
+
+    if (capacity_ <= size_)
+    {
+        // create a new array with grown capacity
+        const vsize newCapacity = GetGrownCapacity(size_ + 1);
+        reserve(newCapacity);
+    }
+
+    // relocate the tail [idx, size_) right by one position with a single memmove
+    // and construct a new element right in the vacated place
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        memmove((void*)&data_[idx + 1], &data_[idx], (size_ - idx) * sizeof(T));
+        new (&data_[idx]) T(value);
+        size_++;
+        return;
+    }
+
+    // insert at the end: just construct a new element in raw memory
+    if (idx == size_)
+    {
+        new (&data_[size_]) T(value);
+        size_++;
+        return;
+    }
+
+    // construct a new last element from the current last one,
+    // then shift right the rest of range [idx, size_-1)
+    new (&data_[size_]) T(std::move(data_[size_ - 1]));
+    std::move_backward(data_ + idx, data_ + size_ - 1, data_ + size_);
+
+    // now we have one more element
+    size_++;
+
+    // set the input element by index
+    data_[idx] = value;
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+inline void cvector<T, Alloc, Growth>::insert_sorted(const T* values, const vsize numValues)
+{
+    insert_sorted_impl(values, numValues, nullptr);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+inline void cvector<T, Alloc, Growth>::insert_sorted(const cvector<T, Alloc, Growth>& values)
+{
+    insert_sorted_impl(values.data(), values.size(), nullptr);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename IdxAlloc>
+inline void cvector<T, Alloc, Growth>::insert_sorted(
+    const T* values,
+    const vsize numValues,
+    cvector<index, IdxAlloc>& outIdxs)
+{
+    outIdxs.resize(numValues);
+    insert_sorted_impl(values, numValues, outIdxs.begin());
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename IdxAlloc>
+inline void cvector<T, Alloc, Growth>::insert_sorted(
+    const cvector<T, Alloc, Growth>& values,
+    cvector<index, IdxAlloc>& outIdxs)
+{
+    outIdxs.resize(values.size());
+    insert_sorted_impl(values.data(), values.size(), outIdxs.begin());
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::insert_sorted_impl(const T* values, const vsize numValues, index* outIdxs)
+{
+    // NOTE: both (*this) cvector and input values must be SORTED,
+    //       values must not point into (*this) cvector
+    // DESC: insert each value at its get_insert_idx() position (after equal
+    //       elements); unlike get_insert_idxs() + insert_before() for each value
+    //       the buffer is grown once and each element is moved only once:
+    //       we merge from the back into the grown buffer
+    // out:  outIdxs -- final index of each inserted value (if not nullptr)
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((numValues < 0) | ((values == nullptr) & (numValues > 0)))
+        {
+            error_msg("invalid input args", CALLER_INFO);
+            return;
+        }
+
+        if (!std::is_sorted(values, values + numValues))
+        {
+            error_msg("input values must be sorted", CALLER_INFO);
+            return;
+        }
+    }
+
+    if (numValues == 0)
+        return;
+
+    const vsize oldSize = size_;
+    const vsize newSize = size_ + numValues;
+
+    if (capacity_ < newSize)
+        reserve(GetGrownCapacity(newSize));
+
+    index src = oldSize - 1;        // the last element which isn't merged yet
+    index dst = newSize - 1;        // where to put the next merged element
+
+    // relocate blocks of old elements which are greater than the current value
+    // with memmove and construct the value in the vacated slot
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        for (index i = numValues - 1; i >= 0; --i)
+        {
+            const index pos   = upper_bound_ptr(data_, data_ + src + 1, values[i]) - data_;
+            const index count = src + 1 - pos;
+
+            if (count > 0)
+            {
+                memmove((void*)&data_[dst - count + 1], &data_[pos], count * sizeof(T));
+                dst -= count;
+                src -= count;
+            }
+
+            new (&data_[dst]) T(values[i]);
+
+            if (outIdxs)
+                outIdxs[i] = dst;
+
+            dst--;
+        }
+
+        size_ = newSize;
+        return;
+    }
+
+    // element-wise merge: slots in [oldSize, newSize) are raw memory so we
+    // construct there, and assign over alive (or moved-from) elements below
+    for (index i = numValues - 1; i >= 0; --i)
+    {
+        // move the old elements which go after the value
+        while ((src >= 0) && (values[i] < data_[src]))
+        {
+            if (dst >= oldSize)
+                new (&data_[dst]) T(std::move(data_[src]));
+            else
+                data_[dst] = std::move(data_[src]);
+
+            --src;
+            --dst;
+        }
+
+        if (dst >= oldSize)
+            new (&data_[dst]) T(values[i]);
+        else
+            data_[dst] = values[i];
+
+        if (outIdxs)
+            outIdxs[i] = dst;
+
+        --dst;
+    }
+
+    size_ = newSize;
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename U>
+void cvector<T, Alloc, Growth>::append_vector(U&& src)
+{
+    // move or copy the input cvector at the end of 
+    // the current one (append one to another)
+
+    const vsize base = size();
+    const vsize srcSize = src.size();
+    vsize newSize = base + srcSize;
+
+    if (capacity_ < newSize)
+    {
+        // create a new array with grown capacity
+        const vsize newCapacity = GetGrownCapacity(newSize);
+        reserve(newCapacity);
+    }
+
+    constexpr bool isRvalue = std::is_rvalue_reference<U&&>::value;
+    constexpr bool isSameVec = std::is_same_v<std::remove_cvref_t<U>, cvector<T, Alloc, Growth>>;
+
+    // bitwise copy of the whole range
+    if constexpr (isSameVec && std::is_trivially_copyable_v<T>)
+    {
+        if (srcSize > 0)
+            memcpy(data_ + base, src.data(), srcSize * sizeof(T));
+    }
+    // bitwise relocation: the source cvector doesn't own the elements anymore
+    else if constexpr (isSameVec && isRvalue && is_trivially_relocatable_v<T>)
+    {
+        if (srcSize > 0)
+            memcpy((void*)(data_ + base), src.data(), srcSize * sizeof(T));
+
+        src.size_ = 0;
+    }
+    else
+    {
+        // move or copy the elements into raw memory
+        for (vsize i = 0; i < srcSize; ++i)
+        {
+            if constexpr (isRvalue)
+            {
+                new (&data_[base + i]) T(std::move(src[i]));
+            }
+            else
+            {
+                new (&data_[base + i]) T(src[i]);
+            }
+        }
+    }
+
+    // if this is an rvalue, destroy the source cvector
+    if constexpr (isRvalue)
+    {
+        src.purge();
+    }
+
+    size_ = newSize;
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
 template <typename Iter>
-inline void cvector<T>::assign(Iter first, Iter last)
+constexpr void cvector<T, Alloc, Growth>::assign(Iter first, Iter last)
 {
     vsize const sz = vsize(last - first);
-    if (size_ < sz) resize(sz);
+
+    clear();
+    reserve(sz);
 
     for (Iter it = first; it != last; ++it)
-        new (&data_[vsize(it - first)]) T(*it);
+        std::construct_at(data_ + vsize(it - first), *it);
+
+    size_ = sz;
 }
 
 
 // =================================================================================
 //                                  search
 // =================================================================================
-template <typename T>
-inline index cvector<T>::find(const T& val) const
+template <typename T, typename Alloc, typename Growth>
+inline index cvector<T, Alloc, Growth>::find(const T& val) const
 {
     // NOTE:  is used for a cvector of RANDOMLY placed values;
     // DESC:  find first matching val and return its index;
     //        if there is no such elements return -1;
 
-    auto it = std::find(begin(), end(), val);
+    // arithmetic types: vectorized scan
+    if constexpr (cvector_simd::is_searchable_v<T>)
+    {
+        return cvector_simd::find(data_, size_, val);
+    }
+    else
+    {
+        auto it = std::find(begin(), end(), val);
+        return (it != end()) ? std::distance(begin(), it) : -1;
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+index cvector<T, Alloc, Growth>::find_any(const T* values, const vsize numValues) const
+{
+    // NOTE:  is used for a cvector of RANDOMLY placed values;
+    // DESC:  find first element which is equal to any of input values
+    //        and return its index; if there is no such elements return -1;
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((values == nullptr) | (numValues < 0))
+        {
+            error_msg("invalid input args", CALLER_INFO);
+            return -1;
+        }
+    }
 
-    return (it != end()) ? std::distance(begin(), it) : -1;
+    if constexpr (cvector_simd::is_searchable_v<T>)
+    {
+        return cvector_simd::find_any(data_, size_, values, numValues);
+    }
+    else
+    {
+        auto it = std::find_first_of(begin(), end(), values, values + numValues);
+        return (it != end()) ? std::distance(begin(), it) : -1;
+    }
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline index cvector<T>::get_idx(const T& val) const
+template <typename T, typename Alloc, typename Growth>
+constexpr index cvector<T, Alloc, Growth>::get_idx(const T& val) const
 {
     // NOTE:  your (*this) cvector must be SORTED!
     // DESC:  get current position (index) into (*this) array for the input value
 
-    return std::distance(begin(), std::upper_bound(begin(), end(), val)) - 1;
+    return std::distance(begin(), upper_bound_ptr(begin(), end(), val)) - 1;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline void cvector<T>::get_idxs(
+template <typename T, typename Alloc, typename Growth>
+template <typename IdxAlloc>
+inline void cvector<T, Alloc, Growth>::get_idxs(
     const T* values,
     const vsize numElems,
-    cvector<index>& outIdxs) const
+    cvector<index, IdxAlloc>& outIdxs,
+    const query_order order) const
 {
     // NOTE:  your (*this) cvector must be SORTED!
     // out:   an arr of idxs to the input values
@@ -628,51 +1523,49 @@ inline void cvector<T>::get_idxs(
     }
    
     outIdxs.resize(numElems);
-
-    for (int i = 0; i < numElems; ++i)
-        outIdxs[i] = std::distance(begin(), std::lower_bound(begin(), end(), values[i]));
+    get_bound_idxs<false>(begin(), end(), values, numElems, outIdxs.begin(), order);
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline void cvector<T>::get_idxs(
-    const cvector<T>& values,
-    cvector<index>& outIdxs) const
+template <typename T, typename Alloc, typename Growth>
+template <typename IdxAlloc>
+inline void cvector<T, Alloc, Growth>::get_idxs(
+    const cvector<T, Alloc, Growth>& values,
+    cvector<index, IdxAlloc>& outIdxs,
+    const query_order order) const
 {
     // NOTE:  your (*this) cvector must be SORTED!
     // out:   an arr of idxs to the input values
 
     outIdxs.resize(values.size());
-
-    for (int i = 0; const T & val : values)
-        outIdxs[i++] = std::distance(begin(), std::lower_bound(begin(), end(), val));
+    get_bound_idxs<false>(begin(), end(), values.data(), values.size(), outIdxs.begin(), order);
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline bool cvector<T>::has_value(const T& val) const
+template <typename T, typename Alloc, typename Growth>
+inline bool cvector<T, Alloc, Growth>::has_value(const T& val) const
 {
     // NOTE:  for a cvector of RANDOMLY placed values:
     // DESC:  check if (*this) cvector has such a value
 
-    return std::find(begin(), end(), val) != end();
+    return find(val) != -1;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline bool cvector<T>::binary_search(const T& val) const
+template <typename T, typename Alloc, typename Growth>
+constexpr bool cvector<T, Alloc, Growth>::binary_search(const T& val) const
 {
     // NOTE: your (*this) cvector must be SORTED!
-    return std::binary_search(begin(), end(), val);
+    return binary_search_ptr(begin(), end(), val);
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-bool cvector<T>::binary_search(const cvector<T>& values) const
+template <typename T, typename Alloc, typename Growth>
+bool cvector<T, Alloc, Growth>::binary_search(const cvector<T, Alloc, Growth>& values) const
 {
     // NOTE: your (*this) cvector must be SORTED!
     // check if each value from the input cvector exists in the current (*this) cvector
@@ -682,15 +1575,15 @@ bool cvector<T>::binary_search(const cvector<T>& values) const
     const T* e = end();
 
     for (index i = 0; i < values.size(); ++i)
-        isExist &= std::binary_search(b + i, e, values[i]);
+        isExist &= binary_search_ptr(b + i, e, values[i]);
 
     return isExist;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-bool cvector<T>::binary_search(const T* values, const vsize numElems) const
+template <typename T, typename Alloc, typename Growth>
+bool cvector<T, Alloc, Growth>::binary_search(const T* values, const vsize numElems) const
 {
     // NOTE: your (*this) cvector must be SORTED!
     // check if each value from the input raw array exists in the current cvector
@@ -709,15 +1602,20 @@ bool cvector<T>::binary_search(const T* values, const vsize numElems) const
     const T* e = end();
 
     for (index i = 0; i < numElems; ++i)
-        isExist &= std::binary_search(b + i, e, values[i]);
+        isExist &= binary_search_ptr(b + i, e, values[i]);
 
     return isExist;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-void cvector<T>::binary_search(const T* values, vsize numElems, cvector<bool>& flags) const
+template <typename T, typename Alloc, typename Growth>
+template <typename FlagAlloc>
+void cvector<T, Alloc, Growth>::binary_search(
+    const T* values,
+    vsize numElems,
+    cvector<bool, FlagAlloc>& flags,
+    const query_order order) const
 {
     // NOTE: your (*this) cvector must be SORTED!
     // check if each value from the input raw array exists and put responsible boolean-flag into output array
@@ -733,59 +1631,365 @@ void cvector<T>::binary_search(const T* values, vsize numElems, cvector<bool>& f
         }
     }
 
-    const T* b = begin();
-    const T* e = end();
-
     flags.resize(numElems);
+    search_flags(begin(), end(), values, 0, numElems, flags.begin(), is_sorted_batch(values, numElems, order));
+}
 
-    for (index i = 0; i < numElems; ++i)
-        flags[i] = std::binary_search(b + i, e, values[i]);
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::search_flags(
+    const T* b,
+    const T* e,
+    const T* values,
+    const index first,
+    const index last,
+    bool* flags,
+    const bool isSorted)
+{
+    // NOTE: value i is searched in range [b+i, e)
+
+    if (isSorted)
+    {
+        // lower bound in [b+i, e) is the max of the global lower bound and b+i
+        const T* it = b;
+
+        for (index i = first; i < last; ++i)
+        {
+            it = gallop_bound_ptr<false>(it, e, values[i]);
+            const index pos = std::max((index)(it - b), i);
+
+            flags[i] = (pos < (e - b)) && !(values[i] < b[pos]);
+        }
+        return;
+    }
+
+    for (index i = first; i < last; ++i)
+        flags[i] = (i < (e - b)) && binary_search_ptr(b + i, e, values[i]);
+}
+
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename U>
+constexpr const T* cvector<T, Alloc, Growth>::lower_bound_ptr(const T* first, const T* last, const U& value)
+{
+    if constexpr (cvector_search::is_branchless_v<T> && std::is_arithmetic_v<U>)
+    {
+        if (!std::is_constant_evaluated())
+            return cvector_search::lower_bound(first, last - first, value);
+    }
+
+    return std::lower_bound(first, last, value);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename U>
+constexpr const T* cvector<T, Alloc, Growth>::upper_bound_ptr(const T* first, const T* last, const U& value)
+{
+    if constexpr (cvector_search::is_branchless_v<T> && std::is_arithmetic_v<U>)
+    {
+        if (!std::is_constant_evaluated())
+            return cvector_search::upper_bound(first, last - first, value);
+    }
+
+    return std::upper_bound(first, last, value);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <typename U>
+constexpr bool cvector<T, Alloc, Growth>::binary_search_ptr(const T* first, const T* last, const U& value)
+{
+    // NOTE: empty (or reversed) range never contains the value
+
+    const T* it = lower_bound_ptr(first, last, value);
+    return (it < last) && !(value < *it);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <bool IsUpper, typename U>
+inline const T* cvector<T, Alloc, Growth>::gallop_bound_ptr(const T* first, const T* last, const U& value)
+{
+    // is the element before the bound we are looking for
+    auto isBefore = [&value](const T& elem)
+    {
+        if constexpr (IsUpper)
+            return !(value < elem);
+        else
+            return elem < value;
+    };
+
+    if ((first >= last) || !isBefore(*first))
+        return first;
+
+    // double the step until we jump over the bound: first[lo] is always before it
+    const ptrdiff_t len  = last - first;
+    ptrdiff_t       lo   = 0;
+    ptrdiff_t       step = 1;
+
+    while ((lo + step < len) && isBefore(first[lo + step]))
+    {
+        lo   += step;
+        step *= 2;
+    }
+
+    // the bound is in (lo, hi]
+    const ptrdiff_t hi = std::min(lo + step, len);
+
+    if constexpr (IsUpper)
+        return upper_bound_ptr(first + lo + 1, first + hi, value);
+    else
+        return lower_bound_ptr(first + lo + 1, first + hi, value);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+inline bool cvector<T, Alloc, Growth>::is_sorted_batch(const T* values, const vsize numValues, const query_order order)
+{
+    if (order == query_order::unknown)
+        return (numValues > 1) && std::is_sorted(values, values + numValues);
+
+    return order == query_order::sorted;
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <bool IsUpper>
+void cvector<T, Alloc, Growth>::get_bound_idxs(
+    const T* b,
+    const T* e,
+    const T* values,
+    const vsize numValues,
+    index* outIdxs,
+    const query_order order)
+{
+    // NOTE: range [b, e) must be SORTED!
+
+    // sorted queries: bounds don't decrease so continue from the previous one
+    if (is_sorted_batch(values, numValues, order))
+    {
+        const T* it = b;
+
+        for (index i = 0; i < numValues; ++i)
+        {
+            it = gallop_bound_ptr<IsUpper>(it, e, values[i]);
+            outIdxs[i] = it - b;
+        }
+        return;
+    }
+
+    for (index i = 0; i < numValues; ++i)
+    {
+        if constexpr (IsUpper)
+            outIdxs[i] = upper_bound_ptr(b, e, values[i]) - b;
+        else
+            outIdxs[i] = lower_bound_ptr(b, e, values[i]) - b;
+    }
 }
 
 
 // =================================================================================
 //                          change size / capacity
 // =================================================================================
-template <typename T>
-inline void cvector<T>::reserve(const vsize newCapacity)
+template <typename T, typename Alloc, typename Growth>
+constexpr void cvector<T, Alloc, Growth>::reserve(const vsize newCapacity, const call_site site)
 {
-   // printf("reserve for :%s of size %d\n", typeid(T).name(), newCapacity);
+    // only raw memory is allocated, no elements are constructed
+
     if (capacity_ < newCapacity)
-        realloc_buffer(newCapacity);
+        realloc_buffer(newCapacity, site);
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-inline void cvector<T>::resize(const vsize newSize)
+template <typename T, typename Alloc, typename Growth>
+inline void cvector<T, Alloc, Growth>::resize(const vsize newSize, const call_site site)
 {
-    if (capacity_ < newSize)
-        realloc_buffer(newSize);
+    // new elements (if any) are value-initialized: T()
+
+    const vsize sz = newSize * (newSize >= 0);
+
+    if (capacity_ < sz)
+        realloc_buffer(sz, site);
 
-    size_ = newSize * (newSize >= 0);
+    if (size_ < sz)
+        std::uninitialized_value_construct(data_ + size_, data_ + sz);
+    else
+        destroy_range(data_ + sz, data_ + size_);
+
+    size_ = sz;
 }
 
 // ----------------------------------------------------
 
-template <typename T>
-void cvector<T>::resize(const vsize newSize, const T& value)
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::resize(const vsize newSize, const T& value, const call_site site)
 {
-    if (capacity_ < newSize)
+    // new elements (if any) are copies of the input value
+
+    const vsize sz = newSize * (newSize >= 0);
+
+    if (capacity_ < sz)
+        realloc_buffer(sz, site);
+
+    if (size_ < sz)
+        std::uninitialized_fill(data_ + size_, data_ + sz, value);
+    else
+        destroy_range(data_ + sz, data_ + size_);
+
+    size_ = sz;
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::resize_default_init(const vsize newSize)
+{
+    // new elements (if any) are default-initialized: for POD-types it means
+    // that memory is left untouched (use it when you are going to overwrite
+    // all the new elements anyway)
+
+    const vsize sz = newSize * (newSize >= 0);
+
+    if (capacity_ < sz)
+        realloc_buffer(sz);
+
+    if (size_ < sz)
+        std::uninitialized_default_construct(data_ + size_, data_ + sz);
+    else
+        destroy_range(data_ + sz, data_ + size_);
+
+    size_ = sz;
+}
+
+
+// =================================================================================
+//                              serialization
+// =================================================================================
+template <typename T, typename Alloc, typename Growth>
+bool cvector<T, Alloc, Growth>::save(const char* path) const requires std::is_trivially_copyable_v<T>
+{
+    // write the elements into a binary file: header, padding, raw elements
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if (path == nullptr)
+        {
+            error_msg("invalid input args", CALLER_INFO);
+            return false;
+        }
+    }
+
+    const cvector_io::file_header header = cvector_io::make_header(data_, size_);
+    const char padding[cvector_io::data_offset<T>()] = { 0 };
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
     {
-        realloc_buffer(newSize);
+        cvector_io::print_error(path, "can't open the file for writing");
+        return false;
+    }
+
+    bool isOk = (fwrite(&header, sizeof(header), 1, file) == 1);
+    isOk &= (fwrite(padding, 1, header.dataOffset - sizeof(header), file) == header.dataOffset - sizeof(header));
+    isOk &= (size_ == 0) || (fwrite(data_, sizeof(T), size_, file) == (size_t)size_);
+    isOk &= (fclose(file) == 0);
+
+    if (!isOk)
+        cvector_io::print_error(path, "can't write into the file");
+
+    return isOk;
+}
+
+// ----------------------------------------------------
 
-        for (vsize i = size_; i < capacity_; ++i)
-            new (&data_[i]) T(value);
+template <typename T, typename Alloc, typename Growth>
+bool cvector<T, Alloc, Growth>::load(const char* path) requires std::is_trivially_copyable_v<T>
+{
+    // read elements from a file which was written with save() (the current
+    // elements are replaced); the checksum is verified;
+    // NOTE: to use the data without copying see cvector_view<T>
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if (path == nullptr)
+        {
+            error_msg("invalid input args", CALLER_INFO);
+            return false;
+        }
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        cvector_io::print_error(path, "can't open the file for reading");
+        return false;
+    }
+
+    cvector_io::file_header header;
+    const char*    errMsg   = nullptr;
+    const uint64_t fileSize = cvector_io::file_size(file);
+
+    if (fread(&header, sizeof(header), 1, file) != 1)
+        errMsg = "the file is truncated";
+    else
+        errMsg = cvector_io::check_header<T>(header, fileSize);
+
+    if (!errMsg)
+    {
+        // the old elements aren't needed: don't copy them on reallocation
+        const vsize count = (vsize)header.count;
+        clear();
+        reserve(count);
+
+        // realloc_buffer() reports a failed allocation and keeps the old buffer
+        if (capacity_ < count)
+            errMsg = "can't allocate memory for the elements";
+        else
+            resize_default_init(count);
     }
-    size_ = newSize * (newSize >= 0);
+
+    if (!errMsg)
+    {
+        const vsize count = size_;
+
+        if (fseek(file, (long)header.dataOffset, SEEK_SET) != 0)
+            errMsg = "the file is truncated";
+
+        else if ((count > 0) && (fread(data_, sizeof(T), count, file) != (size_t)count))
+            errMsg = "the file is truncated";
+
+        else if (cvector_io::checksum(data_, count * sizeof(T)) != header.checksum)
+            errMsg = "checksum mismatch: the file is corrupted";
+    }
+
+    fclose(file);
+
+    if (errMsg)
+    {
+        clear();
+        cvector_io::print_error(path, errMsg);
+        return false;
+    }
+
+    return true;
 }
 
 
 // =================================================================================
 //                            memory deallocation
 // =================================================================================
-template <typename T>
-void cvector<T>::shrink_to_fit()
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::shrink_to_fit()
 {
     // requests the removal of unused capacity. 
     // so the capacity() may be reduced to size().
@@ -796,9 +2000,10 @@ void cvector<T>::shrink_to_fit()
 
 // ----------------------------------------------------
 
-template <typename T>
-void cvector<T>::purge()
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::purge()
 {
+    destroy_range(data_, data_ + size_);
     safe_delete();
     size_ = 0;
     capacity_ = 0;
@@ -808,8 +2013,8 @@ void cvector<T>::purge()
 // =================================================================================
 //                              private methods
 // =================================================================================
-template <typename T>
-void cvector<T>::vassert(
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::vassert(
     const bool condition,
     const char* msg,
     const char* format,
@@ -831,8 +2036,8 @@ void cvector<T>::vassert(
 
 // ----------------------------------------------------
 
-template <typename T>
-void cvector<T>::error_msg(
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::error_msg(
     const char* msg,
     const char* format,
     const char* fileName,
@@ -850,11 +2055,96 @@ void cvector<T>::error_msg(
 
 // ----------------------------------------------------
 
-template <typename T>
-inline void cvector<T>::realloc_buffer_discard(const vsize newCapacity)
+template <typename T, typename Alloc, typename Growth>
+constexpr T* cvector<T, Alloc, Growth>::alloc_raw(const vsize count)
+{
+    // allocate uninitialized memory for count elements of type T
+
+    if (count <= 0)
+        return nullptr;
+
+    return std::to_address(alloc_traits::allocate(alloc_, (size_t)count));
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+constexpr T* cvector<T, Alloc, Growth>::alloc_raw_at_least(vsize& count)
+{
+    // allocate uninitialized memory for AT LEAST count elements;
+    // if the allocator can report the real size of the memory block
+    // (allocate_at_least() as in C++23, see malloc_allocator) the count is
+    // updated so the slack of the block is used as a capacity as well
+
+    if constexpr (requires(Alloc& a, size_t n) { a.allocate_at_least(n); })
+    {
+        if (count <= 0)
+            return nullptr;
+
+        const auto result = alloc_.allocate_at_least((size_t)count);
+        count = (vsize)result.count;
+        return std::to_address(result.ptr);
+    }
+    else
+    {
+        return alloc_raw(count);
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+constexpr void cvector<T, Alloc, Growth>::free_raw(T* ptr, const vsize count)
+{
+    // release memory which was allocated with alloc_raw()
+
+    if (ptr)
+        alloc_traits::deallocate(alloc_, ptr, (size_t)count);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+constexpr void cvector<T, Alloc, Growth>::safe_delete()
+{
+    // release the buffer (elements must be already destroyed)
+
+    if (data_)
+    {
+        if constexpr (cvector_telemetry::ENABLE_TELEMETRY)
+        {
+            if (!std::is_constant_evaluated())
+                cvector_telemetry::on_release<T>(allocSite_, capacity_, size_);
+        }
+
+        free_raw(data_, capacity_);
+        data_ = nullptr;
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+constexpr void cvector<T, Alloc, Growth>::destroy_range(T* first, T* last)
+{
+    // call destructors for elements of range [first, last);
+    // for trivially destructible types it is a no-op;
+    // NOTE: empty or reversed range is just skipped
+
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        for (; first < last; ++first)
+            std::destroy_at(first);
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+inline void cvector<T, Alloc, Growth>::realloc_buffer_discard(const vsize newCapacity, const call_site site)
 {
     // reallocate memory for a new buffer of capacity == newCapacity
-    // without saving an old data;
+    // without saving an old data (all the old elements are destroyed);
     //
     // If reallocation occurs, all iterators(including the end() iterator) 
     // and all references to the elements are invalidated.
@@ -863,13 +2153,24 @@ inline void cvector<T>::realloc_buffer_discard(const vsize newCapacity)
     {
         // if we had any data before
         if (data_)
+        {
+            destroy_range(data_, data_ + size_);
             safe_delete();
+            size_ = 0;
+        }
 
-        data_ = new T[newCapacity];
+        data_ = alloc_raw(newCapacity);
         capacity_ = newCapacity;
+
+        if constexpr (cvector_telemetry::ENABLE_TELEMETRY)
+        {
+            cvector_telemetry::on_alloc<T>(site, 0, newCapacity, 0);
+            allocSite_ = site;
+        }
     }
     catch (const std::bad_alloc& e)
     {
+        capacity_ = 0;
         error_msg(e.what(), CALLER_INFO);
         error_msg("can't allocate memory for buffer", CALLER_INFO);
     }
@@ -877,45 +2178,104 @@ inline void cvector<T>::realloc_buffer_discard(const vsize newCapacity)
 
 // ----------------------------------------------------
 
-template <typename T>
-inline void cvector<T>::realloc_buffer(const vsize newCapacity)
+template <typename T, typename Alloc, typename Growth>
+constexpr void cvector<T, Alloc, Growth>::realloc_buffer(const vsize capacity, const call_site site)
 {
     // If reallocation occurs, all iterators(including the end() iterator) 
     // and all references to the elements are invalidated.
+    //
+    // NOTE: the new capacity can be bigger than requested if the allocator
+    //       reports the real size of the memory block (see alloc_raw_at_least())
 
     try
     {
+        // the allocator can resize the buffer itself (see mremap_allocator):
+        // the pages are remapped instead of copying the elements
+        if constexpr (can_realloc_in_place())
+        {
+            if (data_ && (capacity > 0) && !std::is_constant_evaluated())
+            {
+                if (capacity < size_)
+                {
+                    destroy_range(data_ + capacity, data_ + size_);
+                    size_ = capacity;
+                }
+
+                const auto  result      = alloc_.reallocate_at_least(data_, (size_t)capacity_, (size_t)capacity);
+                const vsize newCapacity = (vsize)result.count;
+
+                if constexpr (cvector_telemetry::ENABLE_TELEMETRY)
+                {
+                    cvector_telemetry::on_alloc<T>(site, capacity_, newCapacity, 0);
+                    cvector_telemetry::on_release<T>(allocSite_, capacity_, size_);
+                    allocSite_ = site;
+                }
+
+                data_     = std::to_address(result.ptr);
+                capacity_ = newCapacity;
+                return;
+            }
+        }
+
+        vsize newCapacity = capacity;
+        T*    newData     = alloc_raw_at_least(newCapacity);
+
+        if constexpr (cvector_telemetry::ENABLE_TELEMETRY)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                const vsize oldCapacity = data_ ? capacity_ : 0;
+                cvector_telemetry::on_alloc<T>(site, oldCapacity, newCapacity, std::min(size_, newCapacity));
+
+                if (data_)
+                    cvector_telemetry::on_release<T>(allocSite_, capacity_, size_);
+
+                allocSite_ = site;
+            }
+        }
+
         // if we had any data before
         if (data_)
         {
-            T* newData = new T[newCapacity]{};
-
             // if we need to store less elements than before
             if (newCapacity < size_)
+            {
+                destroy_range(data_ + newCapacity, data_ + size_);
                 size_ = newCapacity;
-            
-
-            // TODO: test using memmove()
-            // 
-            // move necessary elements into the new buffer
-            for (vsize i = 0; i < size_; ++i)
-                newData[i] = std::move(data_[i]);
+            }
+
+            // constant evaluation: neither memcpy nor uninitialized_move is allowed
+            if (std::is_constant_evaluated())
+            {
+                for (vsize i = 0; i < size_; ++i)
+                {
+                    std::construct_at(newData + i, std::move(data_[i]));
+                    std::destroy_at(data_ + i);
+                }
+            }
+            // relocate alive elements into the new buffer with a single memcpy
+            else if constexpr (is_trivially_relocatable_v<T>)
+            {
+                if (size_ > 0)
+                    memcpy((void*)newData, data_, size_ * sizeof(T));
+            }
+            // move alive elements into the new buffer and destroy the old ones
+            else
+            {
+                std::uninitialized_move(data_, data_ + size_, newData);
+                destroy_range(data_, data_ + size_);
+            }
 
             // release memory from the old buffer
-            delete[] data_;
-
-            data_ = newData;
-            capacity_ = newCapacity;
-        }
-        else
-        {
-            data_ = new T[newCapacity]{};
-            capacity_ = newCapacity;
+            free_raw(data_, capacity_);
         }
+
+        data_ = newData;
+        capacity_ = newCapacity;
     }
     catch (const std::bad_alloc& e)
     {
         error_msg(e.what(), CALLER_INFO);
         error_msg("can't allocate memory for buffer", CALLER_INFO);
     }
-}
\ No newline at end of file
+}
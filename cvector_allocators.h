@@ -0,0 +1,547 @@
+// =================================================================================
+// Filename:     cvector_allocators.h
+// Description:  stateful allocators for cvector:
+//               - arena_resource: grows by chained blocks, released all at once;
+//               - pool_resource:  size-class pools with free lists;
+//               - frame_resource: per-frame linear/stack allocator which
+//                                 is reset wholesale at the end of frame;
+//               - malloc_allocator: malloc/free allocator which reports the real
+//                                 size of blocks so growth claims their slack;
+//               - aligned_allocator: storage aligned to 16/32/64 bytes or a page
+//                                 (aligned SIMD loads, no elements split across
+//                                 cache lines);
+//
+//               each resource is a std::pmr::memory_resource so it can be used
+//               through std::pmr::polymorphic_allocator (pmr_cvector) as well as
+//               through resource_allocator<T, Resource> (without virtual calls)
+//
+//               usage:
+//                   frame_resource frameMem(1 << 20);
+//                   cvector<index, frame_allocator<index>> idxs{ frame_allocator<index>(&frameMem) };
+//                   sortedIds.get_idxs(ids, numIds, idxs);
+//                   ...
+//                   frameMem.reset();    // at the end of frame
+// =================================================================================
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+#if defined(__APPLE__)
+    #include <malloc/malloc.h>
+#elif defined(_MSC_VER) || defined(__GLIBC__) || defined(__linux__)
+    #include <malloc.h>
+#endif
+
+
+namespace cvector_alloc_detail
+{
+    inline size_t align_up(const size_t value, const size_t alignment)
+    {
+        // alignment must be a power of 2
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+
+// =================================================================================
+// ARENA RESOURCE
+//
+// a bump allocator over a chain of memory blocks: deallocate() does nothing,
+// all the memory is released at once with release() (or in destructor);
+// reset() rewinds the arena but keeps the first block for reuse
+// =================================================================================
+class arena_resource final : public std::pmr::memory_resource
+{
+public:
+    explicit arena_resource(
+        const size_t blockSize = 64 * 1024,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) :
+        blockSize_(blockSize),
+        upstream_(upstream)
+    {
+    }
+
+    arena_resource(const arena_resource&) = delete;
+    arena_resource& operator=(const arena_resource&) = delete;
+
+    ~arena_resource() { release(); }
+
+
+    // rewind the arena: free all the blocks except of the first one
+    void reset()
+    {
+        if (!head_)
+            return;
+
+        // the first allocated block is the last one in the chain
+        Block* first = head_;
+        while (first->next)
+        {
+            Block* next = first->next;
+            upstream_->deallocate(first, first->size, alignof(std::max_align_t));
+            first = next;
+        }
+
+        head_  = first;
+        cur_   = (char*)(first + 1);
+        end_   = (char*)first + first->size;
+    }
+
+    // free all the blocks
+    void release()
+    {
+        while (head_)
+        {
+            Block* next = head_->next;
+            upstream_->deallocate(head_, head_->size, alignof(std::max_align_t));
+            head_ = next;
+        }
+
+        cur_ = nullptr;
+        end_ = nullptr;
+    }
+
+protected:
+    void* do_allocate(const size_t bytes, const size_t alignment) override
+    {
+        char* ptr = (char*)cvector_alloc_detail::align_up((uintptr_t)cur_, alignment);
+
+        // if there is not enough space in the current block
+        if (!cur_ || (ptr + bytes > end_))
+        {
+            add_block(bytes + alignment);
+            ptr = (char*)cvector_alloc_detail::align_up((uintptr_t)cur_, alignment);
+        }
+
+        cur_ = ptr + bytes;
+        return ptr;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override
+    {
+        // memory is released all at once by reset() / release()
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    struct alignas(std::max_align_t) Block
+    {
+        Block* next = nullptr;
+        size_t size = 0;
+    };
+
+    void add_block(const size_t minBytes)
+    {
+        const size_t size = std::max(blockSize_, minBytes + sizeof(Block));
+        void* mem = upstream_->allocate(size, alignof(std::max_align_t));
+
+        Block* block = new (mem) Block{ head_, size };
+
+        head_ = block;
+        cur_  = (char*)(block + 1);
+        end_  = (char*)block + size;
+    }
+
+    size_t                     blockSize_ = 0;
+    std::pmr::memory_resource* upstream_ = nullptr;
+    Block*                     head_ = nullptr;
+    char*                      cur_ = nullptr;
+    char*                      end_ = nullptr;
+};
+
+
+// =================================================================================
+// POOL RESOURCE
+//
+// size classes of power of 2 (16 .. maxBlockSize bytes): each class has its own
+// free list of blocks which are cut from pages allocated from the upstream;
+// bigger requests go directly to the upstream
+// =================================================================================
+class pool_resource final : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t minBlockSize = 16;
+    static constexpr size_t maxBlockSize = 4096;
+    static constexpr int    numClasses   = 9;        // 16, 32, ... 4096
+    static constexpr size_t pageSize     = 64 * 1024;
+
+    explicit pool_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) :
+        upstream_(upstream)
+    {
+    }
+
+    pool_resource(const pool_resource&) = delete;
+    pool_resource& operator=(const pool_resource&) = delete;
+
+    ~pool_resource() { release(); }
+
+
+    // free all the pages (all the blocks become invalid)
+    void release()
+    {
+        while (pages_)
+        {
+            Page* next = pages_->next;
+            upstream_->deallocate(pages_, pageSize, alignof(std::max_align_t));
+            pages_ = next;
+        }
+
+        for (FreeBlock*& list : freeLists_)
+            list = nullptr;
+    }
+
+protected:
+    void* do_allocate(const size_t bytes, const size_t alignment) override
+    {
+        const int cls = get_class(bytes, alignment);
+
+        // too big block: ask the upstream
+        if (cls < 0)
+            return upstream_->allocate(bytes, alignment);
+
+        if (!freeLists_[cls])
+            add_page(cls);
+
+        FreeBlock* block = freeLists_[cls];
+        freeLists_[cls] = block->next;
+
+        return block;
+    }
+
+    void do_deallocate(void* ptr, const size_t bytes, const size_t alignment) override
+    {
+        const int cls = get_class(bytes, alignment);
+
+        if (cls < 0)
+        {
+            upstream_->deallocate(ptr, bytes, alignment);
+            return;
+        }
+
+        // return the block into its free list
+        FreeBlock* block = (FreeBlock*)ptr;
+        block->next = freeLists_[cls];
+        freeLists_[cls] = block;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next = nullptr;
+    };
+
+    struct alignas(std::max_align_t) Page
+    {
+        Page* next = nullptr;
+    };
+
+    static int get_class(const size_t bytes, const size_t alignment)
+    {
+        // get index of the size class for the requested block;
+        // return -1 if the block is too big for pooling
+
+        // all the blocks are aligned at least by alignof(std::max_align_t)
+        size_t size = std::max({ bytes, alignment, minBlockSize });
+
+        if ((size > maxBlockSize) | (alignment > alignof(std::max_align_t)))
+            return -1;
+
+        int cls = 0;
+        for (size_t blockSize = minBlockSize; blockSize < size; blockSize <<= 1)
+            ++cls;
+
+        return cls;
+    }
+
+    void add_page(const int cls)
+    {
+        // allocate a new page and cut it into blocks of the size class
+
+        void* mem  = upstream_->allocate(pageSize, alignof(std::max_align_t));
+        Page* page = new (mem) Page{ pages_ };
+        pages_ = page;
+
+        const size_t blockSize = minBlockSize << cls;
+        char*        ptr       = (char*)(page + 1);
+        char*        end       = (char*)page + pageSize;
+
+        for (; ptr + blockSize <= end; ptr += blockSize)
+        {
+            FreeBlock* block = (FreeBlock*)ptr;
+            block->next = freeLists_[cls];
+            freeLists_[cls] = block;
+        }
+    }
+
+    std::pmr::memory_resource* upstream_ = nullptr;
+    Page*                      pages_ = nullptr;
+    FreeBlock*                 freeLists_[numClasses] = { nullptr };
+};
+
+
+// =================================================================================
+// FRAME RESOURCE
+//
+// per-frame linear/stack allocator over a single fixed buffer:
+// - allocation just bumps the top pointer;
+// - deallocation of the topmost block pops it (stack order), the rest is no-op;
+// - get_marker()/free_to_marker() for scoped scratch memory;
+// - reset() releases all the frame memory wholesale (call it at the end of frame);
+//
+// if the buffer is exhausted requests go to the upstream (and are freed on reset)
+// =================================================================================
+class frame_resource final : public std::pmr::memory_resource
+{
+public:
+    using marker = size_t;
+
+    explicit frame_resource(
+        const size_t capacity,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) :
+        overflow_(upstream)
+    {
+        buffer_   = (char*)::operator new(capacity, std::align_val_t(alignof(std::max_align_t)));
+        capacity_ = capacity;
+    }
+
+    frame_resource(const frame_resource&) = delete;
+    frame_resource& operator=(const frame_resource&) = delete;
+
+    ~frame_resource()
+    {
+        ::operator delete(buffer_, std::align_val_t(alignof(std::max_align_t)));
+    }
+
+
+    inline marker get_marker()     const { return top_; }
+    inline size_t used()           const { return top_; }
+    inline size_t capacity()       const { return capacity_; }
+
+    inline void free_to_marker(const marker m) { if (m < top_) top_ = m; }
+
+    // release all the memory of the frame
+    void reset()
+    {
+        top_ = 0;
+        overflow_.release();
+    }
+
+protected:
+    void* do_allocate(const size_t bytes, const size_t alignment) override
+    {
+        const size_t offset = cvector_alloc_detail::align_up(top_, alignment);
+
+        // the frame buffer is exhausted
+        if (offset + bytes > capacity_)
+            return overflow_.allocate(bytes, alignment);
+
+        top_ = offset + bytes;
+        return buffer_ + offset;
+    }
+
+    void do_deallocate(void* ptr, const size_t bytes, size_t) override
+    {
+        // pop the block if it is the topmost one (stack order)
+        if ((char*)ptr + bytes == buffer_ + top_)
+            top_ = (char*)ptr - buffer_;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    char*                                buffer_ = nullptr;
+    size_t                               capacity_ = 0;
+    size_t                               top_ = 0;
+    std::pmr::monotonic_buffer_resource  overflow_;
+};
+
+
+// =================================================================================
+// RESOURCE ALLOCATOR
+//
+// typed stateful allocator which refers to a memory resource; since the resource
+// types are final the calls are devirtualized
+// =================================================================================
+template <typename T, typename Resource>
+class resource_allocator
+{
+public:
+    using value_type = T;
+
+    // containers keep their resource (as std::pmr::polymorphic_allocator does)
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap            = std::false_type;
+    using is_always_equal                        = std::false_type;
+
+    template <typename U>
+    struct rebind { using other = resource_allocator<U, Resource>; };
+
+
+    resource_allocator(Resource* resource) : resource_(resource) {}
+
+    template <typename U>
+    resource_allocator(const resource_allocator<U, Resource>& other) : resource_(other.resource()) {}
+
+    inline T* allocate(const size_t n)
+    {
+        return (T*)resource_->allocate(n * sizeof(T), alignof(T));
+    }
+
+    inline void deallocate(T* ptr, const size_t n)
+    {
+        resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    inline Resource* resource() const { return resource_; }
+
+    template <typename U>
+    bool operator==(const resource_allocator<U, Resource>& rhs) const { return resource_ == rhs.resource(); }
+
+private:
+    Resource* resource_ = nullptr;
+};
+
+
+template <typename T> using arena_allocator = resource_allocator<T, arena_resource>;
+template <typename T> using pool_allocator  = resource_allocator<T, pool_resource>;
+template <typename T> using frame_allocator = resource_allocator<T, frame_resource>;
+
+
+// =================================================================================
+// MALLOC ALLOCATOR
+//
+// stateless allocator over malloc/free; allocate_at_least() (C++23-style protocol
+// which cvector uses when it grows) returns the real size of the block
+// (malloc_usable_size/_msize/malloc_size) so cvector claims the slack of
+// the allocator size class as its capacity; it pairs with growth_pow2
+// =================================================================================
+template <typename T>
+struct malloc_allocation_result
+{
+    T*     ptr;
+    size_t count;
+};
+
+// ----------------------------------------------------
+
+template <typename T>
+class malloc_allocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc_allocator: over-aligned types aren't supported");
+
+public:
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    malloc_allocator() = default;
+
+    template <typename U>
+    malloc_allocator(const malloc_allocator<U>&) {}
+
+    inline T* allocate(const size_t n)
+    {
+        void* ptr = malloc(n * sizeof(T));
+
+        if (!ptr && (n > 0))
+            throw std::bad_alloc();
+
+        return (T*)ptr;
+    }
+
+    inline malloc_allocation_result<T> allocate_at_least(const size_t n)
+    {
+        T* ptr = allocate(n);
+        return { ptr, std::max(n, usable_size(ptr) / sizeof(T)) };
+    }
+
+    inline void deallocate(T* ptr, const size_t)
+    {
+        free(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const malloc_allocator<U>&) const { return true; }
+
+private:
+    static size_t usable_size(void* ptr)
+    {
+        if (!ptr)
+            return 0;
+
+#if defined(__APPLE__)
+        return malloc_size(ptr);
+#elif defined(_MSC_VER)
+        return _msize(ptr);
+#elif defined(__GLIBC__) || defined(__linux__)
+        return malloc_usable_size(ptr);
+#else
+        return 0;
+#endif
+    }
+};
+
+
+// =================================================================================
+// ALIGNED ALLOCATOR
+//
+// the storage is aligned to Alignment bytes (a power of 2 which is >= alignof(T)):
+// 16/32/64 for aligned SIMD loads and cache-line aligned elements, or
+// cvector_page_alignment for page-aligned buffers
+// =================================================================================
+constexpr size_t cvector_page_alignment = 4096;
+
+// ----------------------------------------------------
+
+template <typename T, size_t Alignment>
+class aligned_allocator
+{
+    static_assert((Alignment & (Alignment - 1)) == 0, "aligned_allocator: alignment must be a power of 2");
+    static_assert(Alignment >= alignof(T), "aligned_allocator: alignment must be >= alignof(T)");
+
+public:
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind { using other = aligned_allocator<U, std::max(Alignment, alignof(U))>; };
+
+    static constexpr size_t alignment = Alignment;
+
+    aligned_allocator() = default;
+
+    template <typename U, size_t A>
+    aligned_allocator(const aligned_allocator<U, A>&) {}
+
+    inline T* allocate(const size_t n)
+    {
+        return (T*)::operator new(n * sizeof(T), std::align_val_t(Alignment));
+    }
+
+    inline void deallocate(T* ptr, const size_t n)
+    {
+        ::operator delete(ptr, n * sizeof(T), std::align_val_t(Alignment));
+    }
+
+    // memory can be freed only with the same alignment it was allocated with
+    // (so is_always_equal holds only between allocators of the same alignment)
+    template <typename U, size_t A>
+    bool operator==(const aligned_allocator<U, A>&) const { return A == Alignment; }
+};
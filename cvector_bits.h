@@ -0,0 +1,335 @@
+// =================================================================================
+// Filename:     cvector_bits.h
+// Description:  packed vector of boolean flags: 64 flags per word (8x less memory
+//               than cvector<bool>), the number of set flags is counted with popcnt,
+//               set flags are iterated word by word (find_first_set/find_next_set,
+//               to_idxs) and flag vectors are combined with bitwise AND/OR/XOR;
+//
+//               cvector::binary_search() can write its existence flags right
+//               into cvector_bits:
+//
+//                   cvector_bits visible;
+//                   ids.binary_search(queries, numQueries, visible);
+//                   visible &= inFrustum;
+//                   visible.to_idxs(visibleIdxs);
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+#include <bit>
+#include <cstdint>
+
+
+class cvector_bits
+{
+public:
+    using word_type = uint64_t;
+    static constexpr vsize bitsPerWord = 64;
+
+    cvector_bits() {}
+    explicit cvector_bits(const vsize numBits, const bool value = false) { resize(numBits, value); }
+
+
+    // getters
+    inline bool             operator[](const index i)   const { return test(i); }
+    inline bool             test(const index i)         const { return (words_[i / bitsPerWord] >> (i % bitsPerWord)) & 1; }
+
+    inline bool             empty()                     const { return size_ == 0; }
+    inline vsize            size()                      const { return size_; }
+    inline vsize            num_words()                 const { return words_.size(); }
+    inline const word_type* words()                     const { return words_.data(); }
+    inline word_type*       words()                           { return words_.begin(); }
+
+    bool  operator==(const cvector_bits& rhs) const { return (size_ == rhs.size_) && (words_ == rhs.words_); }
+
+    vsize count() const;                           // the number of set flags
+    bool  any()   const;
+    bool  none()  const { return !any(); }
+    bool  all()   const { return count() == size_; }
+
+    // idx of the first set flag at or after the input idx (-1 if there is no such flag)
+    index find_first_set() const { return find_next_set(0); }
+    index find_next_set(const index from) const;
+
+    // idxs of all the set flags in ascending order
+    void  to_idxs(cvector<index>& outIdxs) const;
+
+
+    // setters
+    inline void set(const index i)                   { words_[i / bitsPerWord] |=  (word_type(1) << (i % bitsPerWord)); }
+    inline void reset(const index i)                 { words_[i / bitsPerWord] &= ~(word_type(1) << (i % bitsPerWord)); }
+    inline void flip(const index i)                  { words_[i / bitsPerWord] ^=  (word_type(1) << (i % bitsPerWord)); }
+    inline void set(const index i, const bool value) { value ? set(i) : reset(i); }
+
+    void push_back(const bool value);
+    void resize(const vsize numBits, const bool value = false);
+    void reserve(const vsize numBits) { words_.reserve(num_words_for(numBits)); }
+    void clear() { words_.clear(); size_ = 0; }
+    void purge() { words_.purge(); size_ = 0; }
+
+    void set_all();
+    void reset_all();
+    void flip_all();
+
+    // bitwise operations between vectors of the same size
+    cvector_bits& operator&=(const cvector_bits& rhs);
+    cvector_bits& operator|=(const cvector_bits& rhs);
+    cvector_bits& operator^=(const cvector_bits& rhs);
+    cvector_bits& and_not(const cvector_bits& rhs);     // (*this) & ~rhs
+
+    friend cvector_bits operator&(cvector_bits lhs, const cvector_bits& rhs) { return lhs &= rhs; }
+    friend cvector_bits operator|(cvector_bits lhs, const cvector_bits& rhs) { return lhs |= rhs; }
+    friend cvector_bits operator^(cvector_bits lhs, const cvector_bits& rhs) { return lhs ^= rhs; }
+
+private:
+    static constexpr vsize num_words_for(const vsize numBits) { return (numBits + bitsPerWord - 1) / bitsPerWord; }
+
+    // NOTE: bits after size_ in the last word are always zero (so count() and
+    // comparison can work with whole words)
+    void clear_tail();
+
+    bool is_same_size(const cvector_bits& rhs, const char* funcName) const;
+
+    template <typename Op>
+    cvector_bits& apply(const cvector_bits& rhs, const char* funcName, Op op);
+
+    cvector<word_type> words_;
+    vsize              size_ = 0;
+};
+
+
+// =================================================================================
+//                                  getters
+// =================================================================================
+inline vsize cvector_bits::count() const
+{
+    return cvector_simd::count_bits(words_.data(), words_.size());
+}
+
+// ----------------------------------------------------
+
+inline bool cvector_bits::any() const
+{
+    for (const word_type word : words_)
+    {
+        if (word) return true;
+    }
+    return false;
+}
+
+// ----------------------------------------------------
+
+inline index cvector_bits::find_next_set(const index from) const
+{
+    if ((from < 0) | (from >= size_))
+        return -1;
+
+    // mask out the flags before the input idx in its word
+    index     w    = from / bitsPerWord;
+    word_type word = words_[w] & (~word_type(0) << (from % bitsPerWord));
+
+    while (!word)
+    {
+        if (++w == words_.size())
+            return -1;
+
+        word = words_[w];
+    }
+
+    return w * bitsPerWord + std::countr_zero(word);
+}
+
+// ----------------------------------------------------
+
+inline void cvector_bits::to_idxs(cvector<index>& outIdxs) const
+{
+    // each word is processed with count trailing zeros + clear the lowest set bit
+    // so the cost depends on the number of set flags rather than the size
+
+    outIdxs.resize(count());
+    index* out = outIdxs.begin();
+
+    for (index w = 0; w < words_.size(); ++w)
+    {
+        for (word_type word = words_[w]; word; word &= word - 1)
+            *out++ = w * bitsPerWord + std::countr_zero(word);
+    }
+}
+
+
+// =================================================================================
+//                                  setters
+// =================================================================================
+inline void cvector_bits::push_back(const bool value)
+{
+    if (size_ % bitsPerWord == 0)
+        words_.push_back(0);
+
+    set(size_++, value);
+}
+
+// ----------------------------------------------------
+
+inline void cvector_bits::resize(const vsize numBits, const bool value)
+{
+    // new flags (if any) are set to the input value
+
+    const vsize sz       = numBits * (numBits >= 0);
+    const vsize oldSize  = size_;
+
+    words_.resize(num_words_for(sz), value ? ~word_type(0) : 0);
+    size_ = sz;
+
+    // the tail of the old last word was zero, fill it too
+    if (value && (oldSize < sz) && (oldSize % bitsPerWord))
+        words_[oldSize / bitsPerWord] |= ~word_type(0) << (oldSize % bitsPerWord);
+
+    clear_tail();
+}
+
+// ----------------------------------------------------
+
+inline void cvector_bits::set_all()
+{
+    std::fill(words_.begin(), words_.end(), ~word_type(0));
+    clear_tail();
+}
+
+// ----------------------------------------------------
+
+inline void cvector_bits::reset_all()
+{
+    std::fill(words_.begin(), words_.end(), word_type(0));
+}
+
+// ----------------------------------------------------
+
+inline void cvector_bits::flip_all()
+{
+    for (word_type& word : words_)
+        word = ~word;
+
+    clear_tail();
+}
+
+
+// =================================================================================
+//                              bitwise operations
+// =================================================================================
+inline cvector_bits& cvector_bits::operator&=(const cvector_bits& rhs)
+{
+    return apply(rhs, "cvector_bits::operator&=()", [](const word_type a, const word_type b) { return a & b; });
+}
+
+// ----------------------------------------------------
+
+inline cvector_bits& cvector_bits::operator|=(const cvector_bits& rhs)
+{
+    return apply(rhs, "cvector_bits::operator|=()", [](const word_type a, const word_type b) { return a | b; });
+}
+
+// ----------------------------------------------------
+
+inline cvector_bits& cvector_bits::operator^=(const cvector_bits& rhs)
+{
+    return apply(rhs, "cvector_bits::operator^=()", [](const word_type a, const word_type b) { return a ^ b; });
+}
+
+// ----------------------------------------------------
+
+inline cvector_bits& cvector_bits::and_not(const cvector_bits& rhs)
+{
+    return apply(rhs, "cvector_bits::and_not()", [](const word_type a, const word_type b) { return a & ~b; });
+}
+
+
+// =================================================================================
+//                              private methods
+// =================================================================================
+inline void cvector_bits::clear_tail()
+{
+    if (size_ % bitsPerWord)
+        words_[words_.size() - 1] &= ~(~word_type(0) << (size_ % bitsPerWord));
+}
+
+// ----------------------------------------------------
+
+inline bool cvector_bits::is_same_size(const cvector_bits& rhs, const char* funcName) const
+{
+    if constexpr (ENABLE_CHECK)
+    {
+        if (size_ != rhs.size_)
+        {
+            cvector_io::print_error(funcName, "flag vectors have different sizes");
+            return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------
+
+template <typename Op>
+inline cvector_bits& cvector_bits::apply(const cvector_bits& rhs, const char* funcName, Op op)
+{
+    // a plain loop over words so the compiler vectorizes it
+
+    if (!is_same_size(rhs, funcName))
+        return *this;
+
+    word_type*       dst = words_.begin();
+    const word_type* src = rhs.words_.data();
+    const vsize      n   = words_.size();
+
+    for (index i = 0; i < n; ++i)
+        dst[i] = op(dst[i], src[i]);
+
+    return *this;
+}
+
+
+// =================================================================================
+//                  cvector::binary_search() into packed flags
+// =================================================================================
+template <typename T, typename Alloc, typename Growth>
+void cvector<T, Alloc, Growth>::binary_search(
+    const T* values,
+    vsize numElems,
+    cvector_bits& flags,
+    const query_order order) const
+{
+    // NOTE: your (*this) cvector must be SORTED!
+    // out: flags -- packed existence flag of each input value
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((values == nullptr) | (numElems < 0))
+        {
+            error_msg("invalid input args", CALLER_INFO);
+            return;
+        }
+    }
+
+    flags.resize(numElems);
+    flags.reset_all();
+
+    const bool isSorted = is_sorted_batch(values, numElems, order);
+    uint64_t*  words    = flags.words();
+
+    // search a word of flags at once and pack them
+    // (value i is searched in [b+i, e), so shift the range with the block)
+    bool blockFlags[cvector_bits::bitsPerWord];
+
+    // NOTE: flags of values after the size of (*this) are always false
+    for (index first = 0; first < std::min(numElems, size_); first += cvector_bits::bitsPerWord)
+    {
+        const index count = std::min(cvector_bits::bitsPerWord, numElems - first);
+        search_flags(begin() + first, end(), values + first, 0, count, blockFlags, isSorted);
+
+        uint64_t word = 0;
+        for (index k = 0; k < count; ++k)
+            word |= uint64_t(blockFlags[k]) << k;
+
+        words[first / cvector_bits::bitsPerWord] = word;
+    }
+}
@@ -0,0 +1,491 @@
+// =================================================================================
+// Filename:     cvector_execution.h
+// Description:  execution policies for the batched methods of cvector
+//               (get_idxs, get_insert_idxs, binary_search with output flags,
+//               get_data_by_idxs) and a built-in thread pool which runs them;
+//
+//               usage:
+//                   #include "cvector_execution.h"
+//                   vec.get_idxs(cvector_exec::par, queries, outIdxs);
+//                   vec.get_idxs(cvector_exec::par.on(myPool), queries, outIdxs);
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+
+namespace cvector_exec
+{
+
+// =================================================================================
+// THREAD POOL
+//
+// runs chunks of a single job on the worker threads and the calling thread;
+// jobs from different threads are executed one after another, and a job which
+// is started from inside of a worker is executed right on this worker
+// =================================================================================
+class thread_pool
+{
+public:
+    // numThreads includes the calling thread so (numThreads-1) workers are created
+    explicit thread_pool(const unsigned numThreads = std::max(1u, std::thread::hardware_concurrency()));
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    inline unsigned num_threads() const { return numWorkers_ + 1; }
+
+    // call func(chunkIdx) for each chunk in [0, numChunks) and wait until all are done
+    template <typename Func>
+    void parallel_for(const ptrdiff_t numChunks, Func&& func);
+
+private:
+    struct job
+    {
+        void (*invoke)(void* ctx, ptrdiff_t chunkIdx);
+        void*                  ctx;
+        ptrdiff_t              numChunks;
+        std::atomic<ptrdiff_t> nextChunk{ 0 };
+        int                    numUsers = 0;     // workers which are running this job (guarded by mutex_)
+    };
+
+    void        worker_loop();
+    static void run_chunks(job& j);
+
+    static inline thread_local bool isWorker_ = false;
+
+    std::unique_ptr<std::thread[]> workers_;
+    unsigned                       numWorkers_ = 0;
+
+    std::mutex              submitMutex_;        // one job at a time
+    std::mutex              mutex_;
+    std::condition_variable jobCv_;              // workers: a new job is here
+    std::condition_variable doneCv_;             // caller: workers left the job
+    job*                    job_ = nullptr;
+    unsigned                generation_ = 0;
+    bool                    stop_ = false;
+};
+
+// ----------------------------------------------------
+
+inline thread_pool::thread_pool(const unsigned numThreads) :
+    numWorkers_((numThreads > 0) ? numThreads - 1 : 0)
+{
+    workers_ = std::make_unique<std::thread[]>(numWorkers_);
+
+    for (unsigned i = 0; i < numWorkers_; ++i)
+        workers_[i] = std::thread(&thread_pool::worker_loop, this);
+}
+
+// ----------------------------------------------------
+
+inline thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    jobCv_.notify_all();
+
+    for (unsigned i = 0; i < numWorkers_; ++i)
+        workers_[i].join();
+}
+
+// ----------------------------------------------------
+
+template <typename Func>
+void thread_pool::parallel_for(const ptrdiff_t numChunks, Func&& func)
+{
+    if (numChunks <= 0)
+        return;
+
+    // nothing to share or a nested call: run right here
+    if ((numWorkers_ == 0) || (numChunks == 1) || isWorker_)
+    {
+        for (ptrdiff_t i = 0; i < numChunks; ++i)
+            func(i);
+        return;
+    }
+
+    using FuncType = std::remove_reference_t<Func>;
+
+    job j;
+    j.invoke    = [](void* ctx, ptrdiff_t chunkIdx) { (*(FuncType*)ctx)(chunkIdx); };
+    j.ctx       = (void*)std::addressof(func);
+    j.numChunks = numChunks;
+
+    std::lock_guard<std::mutex> submitLock(submitMutex_);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &j;
+        generation_++;
+    }
+    jobCv_.notify_all();
+
+    // the calling thread works too
+    run_chunks(j);
+
+    // all the chunks are taken: wait for workers which are still running some
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [&j]() { return j.numUsers == 0; });
+    job_ = nullptr;
+}
+
+// ----------------------------------------------------
+
+inline void thread_pool::run_chunks(job& j)
+{
+    for (;;)
+    {
+        const ptrdiff_t chunkIdx = j.nextChunk.fetch_add(1, std::memory_order_relaxed);
+
+        if (chunkIdx >= j.numChunks)
+            return;
+
+        j.invoke(j.ctx, chunkIdx);
+    }
+}
+
+// ----------------------------------------------------
+
+inline void thread_pool::worker_loop()
+{
+    isWorker_ = true;
+    unsigned seenGeneration = 0;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;)
+    {
+        jobCv_.wait(lock, [&]() { return stop_ || (job_ && (generation_ != seenGeneration)); });
+
+        if (stop_)
+            return;
+
+        seenGeneration = generation_;
+        job* j = job_;
+        j->numUsers++;
+
+        lock.unlock();
+        run_chunks(*j);
+        lock.lock();
+
+        if (--j->numUsers == 0)
+            doneCv_.notify_one();
+    }
+}
+
+// ----------------------------------------------------
+
+inline thread_pool& get_default_thread_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+
+// =================================================================================
+// EXECUTION POLICIES
+//
+// seq       -- run on the calling thread
+// par       -- split the batch into chunks and run them on the thread pool
+// par_unseq -- the same as par: each chunk runs the vectorized kernels
+//              (branchless search, SIMD gather) which seq uses as well
+//
+// par/par_unseq use the default pool (one thread per core) unless another one
+// is given with .on(pool)
+// =================================================================================
+struct sequenced_policy {};
+
+struct parallel_policy
+{
+    thread_pool* pool = nullptr;
+    constexpr parallel_policy on(thread_pool& p) const { return parallel_policy{ &p }; }
+};
+
+struct parallel_unsequenced_policy
+{
+    thread_pool* pool = nullptr;
+    constexpr parallel_unsequenced_policy on(thread_pool& p) const { return parallel_unsequenced_policy{ &p }; }
+};
+
+inline constexpr sequenced_policy            seq{};
+inline constexpr parallel_policy             par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+
+template <typename T>
+constexpr bool is_parallel_policy_v =
+    std::is_same_v<T, parallel_policy> || std::is_same_v<T, parallel_unsequenced_policy>;
+
+// is_execution_policy_v and the execution_policy concept are declared in cvector.h
+template <> inline constexpr bool is_execution_policy_v<sequenced_policy>            = true;
+template <> inline constexpr bool is_execution_policy_v<parallel_policy>             = true;
+template <> inline constexpr bool is_execution_policy_v<parallel_unsequenced_policy> = true;
+
+
+// =================================================================================
+// CHUNKED PARALLEL LOOP
+// =================================================================================
+
+// min number of queries per chunk: smaller chunks don't pay for the scheduling
+constexpr ptrdiff_t minChunkSize = 4096;
+
+// chunk size is a multiple of this number of elements so for any output element
+// size chunks write into different cache lines (except at most one line on each
+// boundary), and also into different 64-bit words of packed bit arrays
+constexpr ptrdiff_t chunkAlignment = 64;
+
+// ----------------------------------------------------
+
+template <typename Policy, typename Func>
+void parallel_chunks(const Policy& policy, const ptrdiff_t numItems, Func&& func)
+{
+    // call func(first, last) for sub-ranges of [0, numItems) in parallel
+
+    if (numItems <= 0)
+        return;
+
+    thread_pool& pool = policy.pool ? *policy.pool : get_default_thread_pool();
+
+    // ~4 chunks per thread for load balancing
+    ptrdiff_t chunkSize = (numItems + pool.num_threads() * 4 - 1) / (pool.num_threads() * 4);
+    chunkSize = std::max(chunkSize, minChunkSize);
+    chunkSize = (chunkSize + chunkAlignment - 1) / chunkAlignment * chunkAlignment;
+
+    const ptrdiff_t numChunks = (numItems + chunkSize - 1) / chunkSize;
+
+    pool.parallel_for(numChunks, [&](const ptrdiff_t chunkIdx)
+    {
+        const ptrdiff_t first = chunkIdx * chunkSize;
+        const ptrdiff_t last  = std::min(first + chunkSize, numItems);
+        func(first, last);
+    });
+}
+
+} // namespace cvector_exec
+
+
+// =================================================================================
+//              cvector: batched methods with an execution policy
+// =================================================================================
+template <typename T, typename Alloc, typename Growth>
+template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+void cvector<T, Alloc, Growth>::get_idxs(
+    Policy&& policy,
+    const T* values,
+    const vsize numElems,
+    cvector<index, IdxAlloc>& outIdxs,
+    const query_order order) const
+{
+    // NOTE:  your (*this) cvector must be SORTED!
+    // out:   an arr of idxs to the input values
+
+    if constexpr (!cvector_exec::is_parallel_policy_v<std::remove_cvref_t<Policy>>)
+    {
+        get_idxs(values, numElems, outIdxs, order);
+    }
+    else
+    {
+        if constexpr (ENABLE_CHECK)
+        {
+            if ((values == nullptr) | (numElems < 0))
+            {
+                error_msg("invalid input args", CALLER_INFO);
+                return;
+            }
+        }
+
+        // check the order once for the whole batch
+        const query_order chunkOrder = is_sorted_batch(values, numElems, order) ? query_order::sorted : query_order::unsorted;
+
+        outIdxs.resize(numElems);
+        index* out = outIdxs.begin();
+
+        cvector_exec::parallel_chunks(policy, numElems, [&](const index first, const index last)
+        {
+            get_bound_idxs<false>(begin(), end(), values + first, last - first, out + first, chunkOrder);
+        });
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+inline void cvector<T, Alloc, Growth>::get_idxs(
+    Policy&& policy,
+    const cvector<T, Alloc, Growth>& values,
+    cvector<index, IdxAlloc>& outIdxs,
+    const query_order order) const
+{
+    if (values.empty())
+    {
+        outIdxs.clear();
+        return;
+    }
+
+    get_idxs(std::forward<Policy>(policy), values.data(), values.size(), outIdxs, order);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+void cvector<T, Alloc, Growth>::get_insert_idxs(
+    Policy&& policy,
+    const T* values,
+    const vsize numValues,
+    cvector<index, IdxAlloc>& idxs,
+    const query_order order) const
+{
+    // get positions (indices) into array for sorted INSERTION
+
+    if constexpr (!cvector_exec::is_parallel_policy_v<std::remove_cvref_t<Policy>>)
+    {
+        get_insert_idxs(values, numValues, idxs, order);
+    }
+    else
+    {
+        if constexpr (ENABLE_CHECK)
+        {
+            if ((values == nullptr) | (numValues < 0))
+            {
+                error_msg("invalid input args", CALLER_INFO);
+                return;
+            }
+        }
+
+        const query_order chunkOrder = is_sorted_batch(values, numValues, order) ? query_order::sorted : query_order::unsorted;
+
+        idxs.resize(numValues);
+        index* out = idxs.begin();
+
+        cvector_exec::parallel_chunks(policy, numValues, [&](const index first, const index last)
+        {
+            get_bound_idxs<true>(begin(), end(), values + first, last - first, out + first, chunkOrder);
+        });
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+inline void cvector<T, Alloc, Growth>::get_insert_idxs(
+    Policy&& policy,
+    const cvector<T, Alloc, Growth>& values,
+    cvector<index, IdxAlloc>& idxs,
+    const query_order order) const
+{
+    if (values.empty())
+    {
+        idxs.clear();
+        return;
+    }
+
+    get_insert_idxs(std::forward<Policy>(policy), values.data(), values.size(), idxs, order);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <cvector_exec::execution_policy Policy, typename FlagAlloc>
+void cvector<T, Alloc, Growth>::binary_search(
+    Policy&& policy,
+    const T* values,
+    vsize numElems,
+    cvector<bool, FlagAlloc>& flags,
+    const query_order order) const
+{
+    // NOTE: your (*this) cvector must be SORTED!
+    // out:  flags -- array of existing flags
+
+    if constexpr (!cvector_exec::is_parallel_policy_v<std::remove_cvref_t<Policy>>)
+    {
+        binary_search(values, numElems, flags, order);
+    }
+    else
+    {
+        if constexpr (ENABLE_CHECK)
+        {
+            if ((values == nullptr) | (numElems < 0))
+            {
+                error_msg("invalid input args", CALLER_INFO);
+                return;
+            }
+        }
+
+        const bool isSorted = is_sorted_batch(values, numElems, order);
+        flags.resize(numElems);
+
+        cvector_exec::parallel_chunks(policy, numElems, [&](const index first, const index last)
+        {
+            search_flags(begin(), end(), values, first, last, flags.begin(), isSorted);
+        });
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <cvector_exec::execution_policy Policy, typename IdxAlloc, typename OutAlloc>
+void cvector<T, Alloc, Growth>::get_data_by_idxs(
+    Policy&& policy,
+    const cvector<index, IdxAlloc>& idxs,
+    cvector<T, OutAlloc>& outData) const
+{
+    // out:  array of data elements by input indices
+
+    if constexpr (cvector_simd::is_bytewise_copyable_v<T>)
+        outData.resize_default_init(idxs.size());
+    else
+        outData.resize(idxs.size());
+
+    get_data_by_idxs(std::forward<Policy>(policy), idxs, outData.begin());
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+template <cvector_exec::execution_policy Policy, typename IdxAlloc>
+void cvector<T, Alloc, Growth>::get_data_by_idxs(
+    Policy&& policy,
+    const cvector<index, IdxAlloc>& idxs,
+    T* outData) const
+{
+    // out:  array of data elements by input indices
+    // NOTE: it is supposed that idxs.size() == outData.size()
+
+    if constexpr (!cvector_exec::is_parallel_policy_v<std::remove_cvref_t<Policy>>)
+    {
+        get_data_by_idxs(idxs, outData);
+    }
+    else
+    {
+        if constexpr (ENABLE_CHECK)
+        {
+            if ((outData == nullptr) && !idxs.empty())
+            {
+                error_msg("invalid input args", CALLER_INFO);
+                return;
+            }
+        }
+
+        const index* pIdxs = idxs.data();
+
+        cvector_exec::parallel_chunks(policy, idxs.size(), [&](const index first, const index last)
+        {
+            gather_idxs(data_, pIdxs + first, last - first, outData + first);
+        });
+    }
+}
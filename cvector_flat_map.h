@@ -0,0 +1,398 @@
+// =================================================================================
+// Filename:     cvector_flat_map.h
+// Description:  sorted flat map on two paired cvectors: SORTED unique keys and
+//               values (value i belongs to key i); keys are searched separately
+//               from values so the key search touches only the keys array, and
+//               iteration over keys is a plain loop over a contiguous array;
+//
+//               bulk insert/erase take SORTED keys and are merged into the map
+//               in a single pass (instead of get_insert_idx + insert_before on
+//               both arrays for each key):
+//
+//                   cvector_flat_map<EntityID, Transform> transforms;
+//                   transforms.insert(ids, data, numIds);           // sorted ids
+//                   transforms.get_values(queryIds, outTransforms);
+//                   for (const EntityID id : transforms.keys()) ...
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+#include "cvector_span.h"
+
+
+template <typename K, typename V>
+class cvector_flat_map
+{
+public:
+    using key_type    = K;
+    using mapped_type = V;
+
+    cvector_flat_map() {}
+
+
+    // getters
+    inline const cvector<K>&  keys()                  const { return keys_; }
+    inline const cvector<V>&  values()                const { return values_; }
+    inline cvector_span<V>    values()                      { return cvector_span<V>(values_.begin(), values_.size()); }
+
+    inline bool               empty()                 const { return keys_.empty(); }
+    inline vsize              size()                  const { return keys_.size(); }
+    inline const K&           key_at(const index i)   const { return keys_[i]; }
+    inline V&                 value_at(const index i)       { return values_[i]; }
+    inline const V&           value_at(const index i) const { return values_[i]; }
+
+
+    // search: idx of the key or -1
+    index    find(const K& key) const;
+    bool     contains(const K& key) const { return find(key) != -1; }
+    V*       get(const K& key);                    // nullptr if there is no such key
+    const V* get(const K& key) const;
+
+    // batched search: outIdxs[i] is idx of keys[i] or -1
+    void find(
+        const K* keys,
+        const vsize numKeys,
+        cvector<index>& outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    // batched values by keys (missing keys get the defaultValue)
+    void get_values(
+        const K* keys,
+        const vsize numKeys,
+        cvector<V>& outValues,
+        const V& defaultValue = V(),
+        const query_order order = query_order::unknown) const;
+
+    void get_values(
+        const cvector<K>& keys,
+        cvector<V>& outValues,
+        const V& defaultValue = V(),
+        const query_order order = query_order::unknown) const;
+
+
+    // setters
+    index insert(const K& key, const V& value);    // insert or assign, return idx of the key
+    bool  erase(const K& key);                     // return false if there is no such key
+
+    // bulk insert/assign of SORTED unique keys in a single merge pass
+    void  insert(const K* keys, const V* values, const vsize numKeys);
+    void  insert(const cvector<K>& keys, const cvector<V>& values);
+
+    // bulk erase by SORTED unique keys (missing keys are ignored), return the number of erased elements
+    vsize erase(const K* keys, const vsize numKeys);
+    vsize erase(const cvector<K>& keys) { return erase(keys.data(), keys.size()); }
+
+    void  reserve(const vsize newCapacity);
+    void  clear();
+    void  purge();
+
+private:
+    // is the key at idx (idx is a lower bound of the key)
+    inline bool is_key_at(const index idx, const K& key) const
+    {
+        return (idx < keys_.size()) && !(key < keys_[idx]);
+    }
+
+    // are the keys sorted and unique
+    static bool is_strictly_sorted(const K* keys, const vsize numKeys)
+    {
+        return std::adjacent_find(keys, keys + numKeys, [](const K& a, const K& b) { return !(a < b); }) == keys + numKeys;
+    }
+
+    cvector<K> keys_;
+    cvector<V> values_;
+};
+
+
+// =================================================================================
+//                                  search
+// =================================================================================
+template <typename K, typename V>
+index cvector_flat_map<K, V>::find(const K& key) const
+{
+    // get_idx() gives the last key which is <= the input one
+    const index idx = keys_.get_idx(key);
+    return ((idx >= 0) && !(keys_[idx] < key)) ? idx : -1;
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+V* cvector_flat_map<K, V>::get(const K& key)
+{
+    const index idx = find(key);
+    return (idx != -1) ? &values_[idx] : nullptr;
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+const V* cvector_flat_map<K, V>::get(const K& key) const
+{
+    const index idx = find(key);
+    return (idx != -1) ? &values_[idx] : nullptr;
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+void cvector_flat_map<K, V>::find(
+    const K* keys,
+    const vsize numKeys,
+    cvector<index>& outIdxs,
+    const query_order order) const
+{
+    // out: idx of each input key (or -1 if there is no such key)
+
+    // an empty cvector of keys has no data (nullptr), don't pass it further
+    if (numKeys == 0)
+    {
+        outIdxs.clear();
+        return;
+    }
+
+    // lower bounds of all the keys (sorted queries are processed in a single pass)
+    keys_.get_idxs(keys, numKeys, outIdxs, order);
+
+    for (index i = 0; i < numKeys; ++i)
+    {
+        if (!is_key_at(outIdxs[i], keys[i]))
+            outIdxs[i] = -1;
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+void cvector_flat_map<K, V>::get_values(
+    const K* keys,
+    const vsize numKeys,
+    cvector<V>& outValues,
+    const V& defaultValue,
+    const query_order order) const
+{
+    // out: value of each input key (or the defaultValue if there is no such key)
+
+    if (numKeys == 0)
+    {
+        outValues.clear();
+        return;
+    }
+
+    cvector<index> idxs;
+    keys_.get_idxs(keys, numKeys, idxs, order);
+
+    outValues.resize(numKeys);
+
+    for (index i = 0; i < numKeys; ++i)
+        outValues[i] = is_key_at(idxs[i], keys[i]) ? values_[idxs[i]] : defaultValue;
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+inline void cvector_flat_map<K, V>::get_values(
+    const cvector<K>& keys,
+    cvector<V>& outValues,
+    const V& defaultValue,
+    const query_order order) const
+{
+    get_values(keys.data(), keys.size(), outValues, defaultValue, order);
+}
+
+
+// =================================================================================
+//                              insert / erase
+// =================================================================================
+template <typename K, typename V>
+index cvector_flat_map<K, V>::insert(const K& key, const V& value)
+{
+    // insert a new pair or assign the value of an existing key
+
+    const index idx = keys_.get_idx(key);
+
+    if ((idx >= 0) && !(keys_[idx] < key))
+    {
+        values_[idx] = value;
+        return idx;
+    }
+
+    keys_.insert_before(idx + 1, key);
+    values_.insert_before(idx + 1, value);
+
+    return idx + 1;
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+bool cvector_flat_map<K, V>::erase(const K& key)
+{
+    const index idx = find(key);
+
+    if (idx == -1)
+        return false;
+
+    keys_.erase(idx);
+    values_.erase(idx);
+
+    return true;
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+void cvector_flat_map<K, V>::insert(const K* keys, const V* values, const vsize numKeys)
+{
+    // NOTE: input keys must be SORTED and unique
+    // DESC: values of existing keys are assigned, new pairs are merged into the map
+    //       from the back in a single pass (each element is moved at most once)
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((numKeys < 0) | (((keys == nullptr) | (values == nullptr)) & (numKeys > 0)))
+        {
+            cvector_io::print_error("cvector_flat_map::insert()", "invalid input args");
+            return;
+        }
+
+        if (!is_strictly_sorted(keys, numKeys))
+        {
+            cvector_io::print_error("cvector_flat_map::insert()", "input keys must be sorted and unique");
+            return;
+        }
+    }
+
+    if (numKeys == 0)
+        return;
+
+    // assign values of existing keys and count the new ones
+    cvector<index> idxs;
+    keys_.get_idxs(keys, numKeys, idxs, query_order::sorted);
+
+    vsize numNew = 0;
+
+    for (index i = 0; i < numKeys; ++i)
+    {
+        if (is_key_at(idxs[i], keys[i]))
+        {
+            values_[idxs[i]] = values[i];
+            idxs[i] = -1;                  // mark as assigned
+        }
+        else
+        {
+            numNew++;
+        }
+    }
+
+    if (numNew == 0)
+        return;
+
+    // merge from the back: the lower bound of a new key i is the number of old
+    // keys which are placed before it
+    const vsize oldSize = keys_.size();
+    keys_.resize(oldSize + numNew);
+    values_.resize(oldSize + numNew);
+
+    index src = oldSize - 1;               // the last not moved old pair
+    index dst = oldSize + numNew - 1;      // the last free position
+
+    for (index i = numKeys - 1; i >= 0; --i)
+    {
+        if (idxs[i] == -1)
+            continue;
+
+        for (; src >= idxs[i]; --src, --dst)
+        {
+            keys_[dst]   = std::move(keys_[src]);
+            values_[dst] = std::move(values_[src]);
+        }
+
+        keys_[dst]   = keys[i];
+        values_[dst] = values[i];
+        --dst;
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+inline void cvector_flat_map<K, V>::insert(const cvector<K>& keys, const cvector<V>& values)
+{
+    if constexpr (ENABLE_CHECK)
+    {
+        if (keys.size() != values.size())
+        {
+            cvector_io::print_error("cvector_flat_map::insert()", "keys and values have different sizes");
+            return;
+        }
+    }
+
+    insert(keys.data(), values.data(), keys.size());
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+vsize cvector_flat_map<K, V>::erase(const K* keys, const vsize numKeys)
+{
+    // NOTE: input keys must be SORTED and unique
+    // DESC: find idxs of existing keys in a single pass and erase pairs from
+    //       both arrays by these idxs (the kept pairs are compacted in a single pass)
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((numKeys < 0) | ((keys == nullptr) & (numKeys > 0)))
+        {
+            cvector_io::print_error("cvector_flat_map::erase()", "invalid input args");
+            return 0;
+        }
+
+        if (!is_strictly_sorted(keys, numKeys))
+        {
+            cvector_io::print_error("cvector_flat_map::erase()", "input keys must be sorted and unique");
+            return 0;
+        }
+    }
+
+    if (numKeys == 0)
+        return 0;
+
+    cvector<index> idxs;
+    find(keys, numKeys, idxs, query_order::sorted);
+
+    // keep only existing keys (idxs are sorted since keys are)
+    const vsize numIdxs = std::remove(idxs.begin(), idxs.end(), -1) - idxs.begin();
+
+    keys_.erase_idxs(idxs.data(), numIdxs);
+    return values_.erase_idxs(idxs.data(), numIdxs);
+}
+
+
+// =================================================================================
+//                                  memory
+// =================================================================================
+template <typename K, typename V>
+inline void cvector_flat_map<K, V>::reserve(const vsize newCapacity)
+{
+    keys_.reserve(newCapacity);
+    values_.reserve(newCapacity);
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+inline void cvector_flat_map<K, V>::clear()
+{
+    keys_.clear();
+    values_.clear();
+}
+
+// ----------------------------------------------------
+
+template <typename K, typename V>
+inline void cvector_flat_map<K, V>::purge()
+{
+    keys_.purge();
+    values_.purge();
+}
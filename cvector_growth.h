@@ -0,0 +1,112 @@
+// =================================================================================
+// Filename:     cvector_growth.h
+// Description:  growth policies of cvector: how much capacity is allocated when
+//               the vector runs out of it (push_back, insert_before, append_vector,
+//               insert_sorted);
+//
+//               a policy is the 3rd template parameter of cvector so different
+//               subsystems can choose opposite trade-offs (tight memory for many
+//               small lists vs. few huge streaming buffers):
+//
+//                   cvector<int>                                         // x1.5, starts from 8
+//                   cvector<int, std::allocator<int>, growth_geometric<2, 1, 64>>
+//                   cvector<Vertex, malloc_allocator<Vertex>, growth_pow2<>>
+//                   cvector<Item, pool_allocator<Item>, growth_fixed_step<16>>
+//
+//               a policy is any type with a static function:
+//                   ptrdiff_t grow(ptrdiff_t capacity, ptrdiff_t required, size_t elemSize)
+//               which returns a new capacity >= required
+// =================================================================================
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+
+
+namespace cvector_growth
+{
+
+template <typename G>
+concept growth_policy = requires(ptrdiff_t capacity, ptrdiff_t required, size_t elemSize)
+{
+    { G::grow(capacity, required, elemSize) } -> std::convertible_to<ptrdiff_t>;
+};
+
+} // namespace cvector_growth
+
+
+// =================================================================================
+// GEOMETRIC GROWTH
+//
+// capacity *= Num/Den (integer math); the first allocation is InitialCapacity
+// =================================================================================
+template <ptrdiff_t Num = 3, ptrdiff_t Den = 2, ptrdiff_t InitialCapacity = 8>
+struct growth_geometric
+{
+    static_assert((Den > 0) && (Num > Den), "growth_geometric: growth factor must be > 1");
+    static_assert(InitialCapacity > 0, "growth_geometric: initial capacity must be > 0");
+
+    static constexpr ptrdiff_t grow(const ptrdiff_t capacity, const ptrdiff_t required, const size_t)
+    {
+        if (capacity == 0)
+            return std::max(InitialCapacity, required);
+
+        // capacity * Num / Den (split so capacity * Num doesn't overflow)
+        const ptrdiff_t grown = capacity / Den * Num + capacity % Den * Num / Den;
+        return std::max({ grown, capacity + 1, required });
+    }
+};
+
+
+// =================================================================================
+// POWER-OF-TWO GROWTH
+//
+// the buffer size in BYTES is a power of two (x2 on each growth): these are
+// the size classes of most allocators (and page multiples for big buffers), so
+// there is no internal fragmentation; with an allocator which can report
+// the real size of a block (malloc_allocator) the rest of slack is claimed too
+// =================================================================================
+template <ptrdiff_t InitialCapacity = 8>
+struct growth_pow2
+{
+    static_assert(InitialCapacity > 0, "growth_pow2: initial capacity must be > 0");
+
+    static constexpr ptrdiff_t grow(const ptrdiff_t capacity, const ptrdiff_t required, const size_t elemSize)
+    {
+        const ptrdiff_t minCapacity = std::max((capacity == 0) ? InitialCapacity : 2 * capacity, required);
+        const size_t    bytes       = std::bit_ceil((size_t)minCapacity * elemSize);
+
+        return (ptrdiff_t)(bytes / elemSize);
+    }
+};
+
+
+// =================================================================================
+// FIXED-STEP GROWTH
+//
+// capacity += Step: for memory-constrained pools where a vector mustn't
+// hold more than Step unused elements (growth costs O(n^2) copying in total
+// so use it for small or rarely growing vectors)
+// =================================================================================
+template <ptrdiff_t Step, ptrdiff_t InitialCapacity = Step>
+struct growth_fixed_step
+{
+    static_assert(Step > 0, "growth_fixed_step: step must be > 0");
+    static_assert(InitialCapacity > 0, "growth_fixed_step: initial capacity must be > 0");
+
+    static constexpr ptrdiff_t grow(const ptrdiff_t capacity, const ptrdiff_t required, const size_t)
+    {
+        if (capacity == 0)
+            return std::max(InitialCapacity, required);
+
+        // the smallest capacity+k*Step which is >= required (k >= 1)
+        const ptrdiff_t numSteps = std::max<ptrdiff_t>((required - capacity + Step - 1) / Step, 1);
+        return capacity + numSteps * Step;
+    }
+};
+
+
+// growth of cvector by default: x1.5, starts from 8 elements
+using default_growth = growth_geometric<>;
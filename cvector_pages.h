@@ -0,0 +1,329 @@
+// =================================================================================
+// Filename:     cvector_pages.h
+// Description:  allocators which map memory right from the OS for big buffers:
+//               - huge_page_allocator: buffers of MinBytes and more are backed by
+//                                 huge pages (2 MB): transparent huge pages
+//                                 (madvise(MADV_HUGEPAGE)) or explicit ones
+//                                 (MAP_HUGETLB) with a fallback to transparent;
+//                                 it removes most of TLB misses of random access
+//                                 into arrays of hundreds of MB (batched get_idxs);
+//
+//               - mremap_allocator: buffers of MinBytes and more are mapped with
+//                                 mmap and grown with mremap(MREMAP_MAYMOVE): cvector
+//                                 of trivially relocatable T remaps pages on growth
+//                                 instead of copying them (no old+new peak either);
+//
+//               smaller buffers go to operator new (malloc/realloc for mremap_allocator);
+//               on non-Linux platforms big buffers are just page-aligned (no huge pages)
+//               and mremap_allocator uses realloc
+//
+//               usage:
+//                   cvector<EntityID, huge_page_allocator<EntityID>> sortedIds;
+//                   cvector<Vertex, mremap_allocator<Vertex>>         bakedVerts;
+// =================================================================================
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+
+    #if defined(MREMAP_MAYMOVE)
+        #define CVECTOR_HAS_MREMAP 1
+    #endif
+#endif
+
+
+// how to back big buffers with huge pages
+enum class huge_pages
+{
+    transparent,                // madvise(MADV_HUGEPAGE): the kernel collapses pages when it can
+    explicit_or_transparent,    // MAP_HUGETLB (reserved pages) if there are free ones, transparent otherwise
+};
+
+
+namespace cvector_pages
+{
+
+constexpr size_t pageSize     = 4096;
+constexpr size_t hugePageSize = size_t(2) << 20;
+
+inline size_t round_up(const size_t bytes, const size_t granularity)
+{
+    return (bytes + granularity - 1) / granularity * granularity;
+}
+
+// ----------------------------------------------------
+
+inline void* map_huge(const size_t bytes, const huge_pages mode)
+{
+    // map (bytes rounded up to huge pages) of zeroed memory;
+    // return nullptr if there is no memory
+
+#if defined(__linux__)
+    const size_t size = round_up(bytes, hugePageSize);
+
+    #if defined(MAP_HUGETLB)
+    if (mode == huge_pages::explicit_or_transparent)
+    {
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (ptr != MAP_FAILED)
+            return ptr;
+    }
+    #endif
+
+    // the kernel can use a huge page only for a 2 MB aligned range:
+    // map a bit more and trim the unaligned head and tail
+    char* raw = (char*)mmap(nullptr, size + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (raw == (char*)MAP_FAILED)
+        return nullptr;
+
+    char*        ptr  = (char*)round_up((size_t)raw, hugePageSize);
+    const size_t head = ptr - raw;
+
+    if (head > 0)
+        munmap(raw, head);
+
+    munmap(ptr + size, hugePageSize - head);
+
+    #if defined(MADV_HUGEPAGE)
+    madvise(ptr, size, MADV_HUGEPAGE);
+    #endif
+
+    return ptr;
+#else
+    (void)mode;
+    return ::operator new(round_up(bytes, hugePageSize), std::align_val_t(pageSize), std::nothrow);
+#endif
+}
+
+// ----------------------------------------------------
+
+inline void unmap_huge(void* ptr, const size_t bytes)
+{
+#if defined(__linux__)
+    munmap(ptr, round_up(bytes, hugePageSize));
+#else
+    ::operator delete(ptr, std::align_val_t(pageSize));
+#endif
+}
+
+} // namespace cvector_pages
+
+
+// =================================================================================
+// HUGE PAGE ALLOCATOR
+//
+// buffers of MinBytes and more are mapped with huge pages (the size is rounded up
+// to 2 MB and allocate_at_least() reports the rounded capacity so cvector claims
+// it), smaller ones are allocated with operator new aligned to a cache line
+// =================================================================================
+template <typename T, huge_pages Mode = huge_pages::transparent, size_t MinBytes = cvector_pages::hugePageSize>
+class huge_page_allocator
+{
+public:
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind { using other = huge_page_allocator<U, Mode, MinBytes>; };
+
+    static constexpr size_t smallAlignment = std::max<size_t>(alignof(T), 64);
+
+    huge_page_allocator() = default;
+
+    template <typename U>
+    huge_page_allocator(const huge_page_allocator<U, Mode, MinBytes>&) {}
+
+    inline T* allocate(const size_t n)
+    {
+        return allocate_at_least(n).ptr;
+    }
+
+    struct allocation_result
+    {
+        T*     ptr;
+        size_t count;
+    };
+
+    allocation_result allocate_at_least(const size_t n)
+    {
+        const size_t bytes = n * sizeof(T);
+
+        if (!is_huge(bytes))
+            return { (T*)::operator new(bytes, std::align_val_t(smallAlignment)), n };
+
+        void* ptr = cvector_pages::map_huge(bytes, Mode);
+
+        if (!ptr)
+            throw std::bad_alloc();
+
+        return { (T*)ptr, cvector_pages::round_up(bytes, cvector_pages::hugePageSize) / sizeof(T) };
+    }
+
+    void deallocate(T* ptr, const size_t n)
+    {
+        const size_t bytes = n * sizeof(T);
+
+        if (is_huge(bytes))
+            cvector_pages::unmap_huge(ptr, bytes);
+        else
+            ::operator delete(ptr, bytes, std::align_val_t(smallAlignment));
+    }
+
+    template <typename U>
+    bool operator==(const huge_page_allocator<U, Mode, MinBytes>&) const { return true; }
+
+private:
+    static constexpr bool is_huge(const size_t bytes) { return bytes >= MinBytes; }
+};
+
+
+// =================================================================================
+// MREMAP ALLOCATOR
+//
+// buffers of MinBytes and more are mapped with mmap (the size is rounded up to
+// pages and reported by allocate_at_least()), smaller ones come from malloc;
+//
+// reallocate_at_least() (which cvector uses on growth of trivially relocatable
+// types) grows a mapped buffer with mremap(MREMAP_MAYMOVE): the kernel moves
+// page table entries instead of the bytes, so growth of a GB-sized vector
+// costs O(pages) and doesn't need the old and new buffers at once;
+// small buffers are grown with realloc
+// =================================================================================
+template <typename T>
+struct mremap_allocation_result
+{
+    T*     ptr;
+    size_t count;
+};
+
+// ----------------------------------------------------
+
+template <typename T, size_t MinBytes = size_t(1) << 20>
+class mremap_allocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "mremap_allocator: over-aligned types aren't supported");
+
+public:
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind { using other = mremap_allocator<U, MinBytes>; };
+
+    mremap_allocator() = default;
+
+    template <typename U>
+    mremap_allocator(const mremap_allocator<U, MinBytes>&) {}
+
+    inline T* allocate(const size_t n)
+    {
+        return allocate_at_least(n).ptr;
+    }
+
+    mremap_allocation_result<T> allocate_at_least(const size_t n)
+    {
+        const size_t bytes = n * sizeof(T);
+
+        if (!is_mapped(bytes))
+        {
+            void* ptr = malloc(bytes);
+
+            if (!ptr && (n > 0))
+                throw std::bad_alloc();
+
+            return { (T*)ptr, n };
+        }
+
+#if defined(CVECTOR_HAS_MREMAP)
+        const size_t size = cvector_pages::round_up(bytes, cvector_pages::pageSize);
+        void*        ptr  = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (ptr == MAP_FAILED)
+            throw std::bad_alloc();
+
+        return { (T*)ptr, size / sizeof(T) };
+#else
+        return {};
+#endif
+    }
+
+    void deallocate(T* ptr, const size_t n)
+    {
+        const size_t bytes = n * sizeof(T);
+
+        if (!is_mapped(bytes))
+        {
+            free(ptr);
+            return;
+        }
+
+#if defined(CVECTOR_HAS_MREMAP)
+        munmap(ptr, cvector_pages::round_up(bytes, cvector_pages::pageSize));
+#endif
+    }
+
+    mremap_allocation_result<T> reallocate_at_least(T* ptr, const size_t oldCount, const size_t newCount)
+    {
+        // resize the buffer keeping its first min(oldCount, newCount) elements
+        // (they are moved bitwise); the old pointer is invalid after the call
+
+        const size_t oldBytes = oldCount * sizeof(T);
+        const size_t newBytes = newCount * sizeof(T);
+
+        // both are small: realloc
+        if (!is_mapped(oldBytes) && !is_mapped(newBytes))
+        {
+            void* newPtr = realloc(ptr, newBytes);
+
+            if (!newPtr)
+                throw std::bad_alloc();
+
+            return { (T*)newPtr, newCount };
+        }
+
+#if defined(CVECTOR_HAS_MREMAP)
+        // both are mapped: remap the pages
+        if (is_mapped(oldBytes) && is_mapped(newBytes))
+        {
+            const size_t oldSize = cvector_pages::round_up(oldBytes, cvector_pages::pageSize);
+            const size_t newSize = cvector_pages::round_up(newBytes, cvector_pages::pageSize);
+            void*        newPtr  = mremap(ptr, oldSize, newSize, MREMAP_MAYMOVE);
+
+            if (newPtr == MAP_FAILED)
+                throw std::bad_alloc();
+
+            return { (T*)newPtr, newSize / sizeof(T) };
+        }
+#endif
+
+        // the buffer crosses the threshold: copy once into the other kind of memory
+        const mremap_allocation_result<T> result = allocate_at_least(newCount);
+
+        memcpy((void*)result.ptr, ptr, std::min(oldBytes, newBytes));
+        deallocate(ptr, oldCount);
+
+        return result;
+    }
+
+    template <typename U>
+    bool operator==(const mremap_allocator<U, MinBytes>&) const { return true; }
+
+private:
+    static constexpr bool is_mapped(const size_t bytes)
+    {
+#if defined(CVECTOR_HAS_MREMAP)
+        return bytes >= MinBytes;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+};
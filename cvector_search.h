@@ -0,0 +1,88 @@
+// =================================================================================
+// Filename:     cvector_search.h
+// Description:  search algorithms over sorted arrays which are used by
+//               the cvector sorted-lookup family (get_idx, get_idxs,
+//               get_insert_idx(s), binary_search)
+// =================================================================================
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #define CVECTOR_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+    #define CVECTOR_PREFETCH(addr) __builtin_prefetch((const void*)(addr))
+#endif
+
+
+namespace cvector_search
+{
+
+// can we use branchless search for values of type T
+template <typename T>
+constexpr bool is_branchless_v = std::is_arithmetic_v<T>;
+
+
+// =================================================================================
+// branchless binary search
+//
+// the range is halved on each step without a branch (the comparison result
+// is used as a multiplier instead of a condition),
+// and both possible midpoints of the next step are prefetched so the memory
+// latency of large arrays is overlapped with the current comparison
+// =================================================================================
+template <typename T, typename U>
+inline const T* lower_bound(const T* first, ptrdiff_t len, const U& value)
+{
+    // return a pointer to the first element which is NOT less than value
+
+    if (len <= 0)
+        return first;
+
+    const T* base = first;
+
+    while (len > 1)
+    {
+        const ptrdiff_t half = len / 2;
+        const ptrdiff_t nextHalf = (len - half) / 2;
+
+        CVECTOR_PREFETCH(base + nextHalf - 1);
+        CVECTOR_PREFETCH(base + half + nextHalf - 1);
+
+        base += (ptrdiff_t)(base[half - 1] < value) * half;
+        len -= half;
+    }
+
+    return base + (*base < value);
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename U>
+inline const T* upper_bound(const T* first, ptrdiff_t len, const U& value)
+{
+    // return a pointer to the first element which is greater than value
+
+    if (len <= 0)
+        return first;
+
+    const T* base = first;
+
+    while (len > 1)
+    {
+        const ptrdiff_t half = len / 2;
+        const ptrdiff_t nextHalf = (len - half) / 2;
+
+        CVECTOR_PREFETCH(base + nextHalf - 1);
+        CVECTOR_PREFETCH(base + half + nextHalf - 1);
+
+        base += (ptrdiff_t)!(value < base[half - 1]) * half;
+        len -= half;
+    }
+
+    return base + !(value < *base);
+}
+
+} // namespace cvector_search
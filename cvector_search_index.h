@@ -0,0 +1,236 @@
+// =================================================================================
+// Filename:     cvector_search_index.h
+// Description:  read-mostly search index which is built from a SORTED cvector:
+//               values are stored in Eytzinger (BFS) layout so the top levels
+//               of the search tree share a few cache lines and the next levels
+//               can be prefetched ahead; query results are indices into
+//               the source cvector;
+//
+//               NOTE: the index is a snapshot; call rebuild() after the source
+//                     cvector is changed
+//
+//               usage:
+//                   cvector_search_index<int> idx(sortedIds);
+//                   const index i = idx.get_idx(id);   // == sortedIds.get_idx(id)
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+#include <bit>
+
+
+template <typename T>
+class cvector_search_index
+{
+public:
+    cvector_search_index() {}
+
+    template <typename Alloc, typename Growth>
+    explicit cvector_search_index(const cvector<T, Alloc, Growth>& src) { rebuild(src); }
+
+
+    // (re)build the index from sorted data
+    template <typename Alloc, typename Growth>
+    inline void rebuild(const cvector<T, Alloc, Growth>& src) { rebuild(src.data(), src.size()); }
+    void        rebuild(const T* sortedData, const vsize numElems);
+
+    inline vsize size()  const { return size_; }
+    inline bool  empty() const { return size_ == 0; }
+
+    // search: all the returned indices are indices into the source cvector
+    index lower_bound(const T& value) const;
+    index upper_bound(const T& value) const;
+    index get_idx(const T& value) const;
+    bool  binary_search(const T& value) const;
+
+    template <typename IdxAlloc>
+    void get_idxs(const T* values, const vsize numValues, cvector<index, IdxAlloc>& outIdxs) const;
+
+    template <typename FlagAlloc>
+    void binary_search(const T* values, const vsize numValues, cvector<bool, FlagAlloc>& flags) const;
+
+private:
+    vsize build_recursive(const T* sortedData, vsize srcIdx, const vsize k);
+
+    // get the tree node of the lower/upper bound (0 if there is no such node)
+    template <bool IsUpper>
+    vsize search_node(const T& value) const;
+
+    // how many tree nodes are placed in a single cache line
+    static constexpr vsize nodesPerLine = (sizeof(T) < 64) ? (64 / sizeof(T)) : 1;
+
+    cvector<T>     tree_;           // Eytzinger layout, 1-based (tree_[0] is unused)
+    cvector<index> srcIdxs_;        // tree node => index into the source cvector
+    vsize          size_ = 0;
+};
+
+
+// =================================================================================
+//                                  build
+// =================================================================================
+template <typename T>
+void cvector_search_index<T>::rebuild(const T* sortedData, const vsize numElems)
+{
+    // in-order traversal of the implicit tree (node k has children 2k and 2k+1)
+    // visits the nodes in the sorted order
+
+    size_ = (numElems > 0) ? numElems : 0;
+
+    tree_.clear();
+    srcIdxs_.clear();
+
+    if (size_ == 0)
+        return;
+
+    tree_.resize(size_ + 1);
+    srcIdxs_.resize(size_ + 1);
+    srcIdxs_[0] = size_;
+
+    build_recursive(sortedData, 0, 1);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+vsize cvector_search_index<T>::build_recursive(const T* sortedData, vsize srcIdx, const vsize k)
+{
+    // return the next source index to put into the tree
+
+    if (k <= size_)
+    {
+        srcIdx = build_recursive(sortedData, srcIdx, 2 * k);
+
+        tree_[k]    = sortedData[srcIdx];
+        srcIdxs_[k] = srcIdx;
+        srcIdx++;
+
+        srcIdx = build_recursive(sortedData, srcIdx, 2 * k + 1);
+    }
+
+    return srcIdx;
+}
+
+
+// =================================================================================
+//                                  search
+// =================================================================================
+template <typename T>
+template <bool IsUpper>
+inline vsize cvector_search_index<T>::search_node(const T& value) const
+{
+    const T*  tree = tree_.data();
+    vsize     k    = 1;
+
+    while (k <= size_)
+    {
+        // prefetch the descendants of k which are (log2(nodesPerLine)) levels below:
+        // all of them are in the same cache line
+        // (may point past the tree: prefetch never faults)
+        CVECTOR_PREFETCH((uintptr_t)tree + (uintptr_t)(k * nodesPerLine) * sizeof(T));
+
+        if constexpr (IsUpper)
+            k = 2 * k + !(value < tree[k]);
+        else
+            k = 2 * k + (tree[k] < value);
+    }
+
+    // we went right on each level after the last left turn: cancel these
+    // right turns and the last left one to get the bound node
+    k >>= std::countr_one((size_t)k) + 1;
+
+    return k;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+inline index cvector_search_index<T>::lower_bound(const T& value) const
+{
+    // index of the first element which is NOT less than value (or size if none)
+
+    return (size_ > 0) ? srcIdxs_[search_node<false>(value)] : 0;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+inline index cvector_search_index<T>::upper_bound(const T& value) const
+{
+    // index of the first element which is greater than value (or size if none)
+
+    return (size_ > 0) ? srcIdxs_[search_node<true>(value)] : 0;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+inline index cvector_search_index<T>::get_idx(const T& value) const
+{
+    // the same as cvector::get_idx(): the last element which is <= value
+
+    return upper_bound(value) - 1;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+inline bool cvector_search_index<T>::binary_search(const T& value) const
+{
+    if (size_ == 0)
+        return false;
+
+    const vsize k = search_node<false>(value);
+    return (k != 0) && !(value < tree_[k]);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+template <typename IdxAlloc>
+void cvector_search_index<T>::get_idxs(
+    const T* values,
+    const vsize numValues,
+    cvector<index, IdxAlloc>& outIdxs) const
+{
+    // the same as cvector::get_idxs(): lower bound idx for each input value
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((values == nullptr) | (numValues < 0))
+        {
+            cvector_io::print_error("cvector_search_index::get_idxs()", "invalid input args");
+            return;
+        }
+    }
+
+    outIdxs.resize(numValues);
+
+    for (vsize i = 0; i < numValues; ++i)
+        outIdxs[i] = lower_bound(values[i]);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+template <typename FlagAlloc>
+void cvector_search_index<T>::binary_search(
+    const T* values,
+    const vsize numValues,
+    cvector<bool, FlagAlloc>& flags) const
+{
+    // check if each input value exists
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((values == nullptr) | (numValues < 0))
+        {
+            cvector_io::print_error("cvector_search_index::binary_search()", "invalid input args");
+            return;
+        }
+    }
+
+    flags.resize(numValues);
+
+    for (vsize i = 0; i < numValues; ++i)
+        flags[i] = binary_search(values[i]);
+}
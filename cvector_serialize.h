@@ -0,0 +1,165 @@
+// =================================================================================
+// Filename:     cvector_serialize.h
+// Description:  versioned binary format of cvector files (for trivially copyable
+//               element types) which are written with cvector::save() and read
+//               with cvector::load() or mapped into memory with cvector_view<T>;
+//
+//               layout:
+//                   file_header (56 bytes)
+//                   zero padding up to header.dataOffset (64-byte aligned)
+//                   count * elemSize bytes of elements (native byte order)
+// =================================================================================
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+
+namespace cvector_io
+{
+
+constexpr char     fileMagic[8]  = { 'C', 'V', 'E', 'C', 'T', 'O', 'R', '\0' };
+constexpr uint32_t fileVersion   = 1;
+constexpr uint32_t endianTag     = 0x01020304;   // is read back in another order on a different-endian CPU
+
+// elements start at an offset which is aligned to this value (or to alignof(T) if bigger)
+constexpr uint64_t dataAlignment = 64;
+
+// ----------------------------------------------------
+
+struct file_header
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t elemSize;
+    uint64_t elemAlign;
+    uint64_t count;
+    uint64_t dataOffset;        // from the beginning of the file
+    uint64_t checksum;          // of the elements bytes (see checksum())
+};
+
+static_assert(sizeof(file_header) == 56, "cvector_io: unexpected padding in file_header");
+
+// ----------------------------------------------------
+
+inline uint64_t checksum(const void* data, const size_t numBytes)
+{
+    // 64-bit hash of bytes: 4 independent lanes over 8-byte words, so it runs
+    // close to the memory bandwidth, then the tail is mixed byte by byte
+
+    constexpr uint64_t prime = 0x9E3779B97F4A7C15ull;
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t lanes[4] = { prime, prime ^ 1, prime ^ 2, prime ^ 3 };
+    size_t   i = 0;
+
+    for (; i + 32 <= numBytes; i += 32)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            uint64_t word;
+            memcpy(&word, bytes + i + 8 * k, sizeof(word));
+
+            lanes[k] = (lanes[k] ^ word) * prime;
+            lanes[k] ^= lanes[k] >> 29;
+        }
+    }
+
+    uint64_t hash = (uint64_t)numBytes * prime;
+
+    for (int k = 0; k < 4; ++k)
+        hash = (hash ^ lanes[k]) * prime;
+
+    for (; i < numBytes; ++i)
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+
+    return hash ^ (hash >> 32);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+constexpr uint64_t data_offset()
+{
+    const uint64_t alignment = std::max<uint64_t>(dataAlignment, alignof(T));
+    return (sizeof(file_header) + alignment - 1) / alignment * alignment;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+file_header make_header(const T* data, const ptrdiff_t count)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "cvector_io: elements must be trivially copyable");
+
+    file_header header;
+    memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version    = fileVersion;
+    header.endianTag  = endianTag;
+    header.elemSize   = sizeof(T);
+    header.elemAlign  = alignof(T);
+    header.count      = (uint64_t)count;
+    header.dataOffset = data_offset<T>();
+    header.checksum   = checksum(data, (size_t)count * sizeof(T));
+
+    return header;
+}
+
+// ----------------------------------------------------
+
+inline uint64_t file_size(FILE* file)
+{
+    // return the size of the opened file in bytes (or UINT64_MAX if it can't be got);
+    // the read position is moved to the beginning of the file
+
+#if defined(_WIN32)
+    const bool isOk = (_fseeki64(file, 0, SEEK_END) == 0);
+    const int64_t size = isOk ? _ftelli64(file) : -1;
+#else
+    const bool isOk = (fseeko(file, 0, SEEK_END) == 0);
+    const int64_t size = isOk ? (int64_t)ftello(file) : -1;
+#endif
+
+    rewind(file);
+    return (size >= 0) ? (uint64_t)size : UINT64_MAX;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+const char* check_header(const file_header& header, const uint64_t fileSize)
+{
+    // return an error message if the file can't be read as elements of type T
+    // (fileSize is the size of the whole file or UINT64_MAX if it's unknown)
+
+    if (memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0)
+        return "not a cvector file";
+
+    if (header.endianTag != endianTag)
+        return "the file was written on a CPU with another byte order";
+
+    if (header.version != fileVersion)
+        return "unsupported version of the file format";
+
+    if ((header.elemSize != sizeof(T)) || (header.elemAlign != alignof(T)))
+        return "element size/alignment in the file doesn't match the type";
+
+    if ((header.dataOffset < sizeof(file_header)) || (header.dataOffset % alignof(T) != 0))
+        return "invalid data offset";
+
+    if (header.count > (uint64_t)PTRDIFF_MAX / sizeof(T))
+        return "invalid number of elements";
+
+    if ((fileSize != UINT64_MAX) && ((fileSize < header.dataOffset) || ((fileSize - header.dataOffset) / sizeof(T) < header.count)))
+        return "the file is truncated";
+
+    return nullptr;
+}
+
+
+} // namespace cvector_io
@@ -0,0 +1,805 @@
+// =================================================================================
+// Filename:     cvector_simd.h
+// Description:  SIMD kernels for linear search (find/has_value/find_any)
+//               over arrays of arithmetic (and opted-in POD) types,
+//               for stream compaction (erase_if), for indexed gather
+//               (get_data_by_idxs) and for counting bits of packed flags (cvector_bits);
+//
+//               kernels for AVX2 and SSE4.2 are compiled with per-function
+//               target attributes and chosen at runtime by CPU features,
+//               on other CPUs (or with CVECTOR_NO_SIMD defined) the scalar
+//               fallback is used
+// =================================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <type_traits>
+
+#include "cvector_search.h"
+
+// how many elements ahead gather (get_data_by_idxs) prefetches the source data
+#ifndef CVECTOR_GATHER_PREFETCH_DISTANCE
+    #define CVECTOR_GATHER_PREFETCH_DISTANCE 16
+#endif
+
+#if !defined(CVECTOR_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+    #define CVECTOR_SIMD_X86 1
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define CVECTOR_TARGET_AVX2
+        #define CVECTOR_TARGET_SSE42
+    #else
+        #define CVECTOR_TARGET_AVX2  __attribute__((target("avx2")))
+        #define CVECTOR_TARGET_SSE42 __attribute__((target("sse4.2")))
+    #endif
+#endif
+
+
+// =================================================================================
+// BITWISE COMPARABLE TRAIT
+//
+// a value of such type is equal to another one if and only if their bytes are equal
+// so we can compare them as integers of the same size;
+// by default: integral types, enums and pointers; you can opt-in your own
+// small POD types (of size 1, 2, 4 or 8 bytes) with defaulted comparison:
+//
+//     template<> struct is_bitwise_comparable<MyId> : std::true_type {};
+// =================================================================================
+template <typename T>
+struct is_bitwise_comparable : std::bool_constant<
+    std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>> {};
+
+template <typename T>
+constexpr bool is_bitwise_comparable_v = is_bitwise_comparable<T>::value;
+
+
+namespace cvector_simd
+{
+
+// can we use SIMD kernels to search for values of type T
+template <typename T>
+constexpr bool is_searchable_v =
+    std::is_same_v<T, float> ||
+    std::is_same_v<T, double> ||
+    (is_bitwise_comparable_v<T> && std::is_trivially_copyable_v<T> &&
+     (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8));
+
+// can elements of T be copied as raw bytes (see remove_if, gather)
+template <typename T>
+constexpr bool is_bytewise_copyable_v = std::is_trivially_copyable_v<T>;
+
+// prefetch distance (in elements) for gather of big elements
+constexpr ptrdiff_t gatherPrefetchDistance = CVECTOR_GATHER_PREFETCH_DISTANCE;
+
+// gather processes idxs by blocks of ~512 bytes of data: if the whole block
+// of idxs is consecutive it is copied with a single memcpy
+template <typename T>
+constexpr ptrdiff_t gatherBlockSize = std::max<ptrdiff_t>(8, 512 / sizeof(T));
+
+// lane type which is used for the comparison of T
+template <typename T>
+using lane_t =
+    std::conditional_t<std::is_floating_point_v<T>, T,
+    std::conditional_t<sizeof(T) == 1, uint8_t,
+    std::conditional_t<sizeof(T) == 2, uint16_t,
+    std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>>;
+
+
+// =================================================================================
+// runtime dispatch
+// =================================================================================
+enum class simd_level
+{
+    scalar,
+    sse42,
+    avx2,
+};
+
+inline simd_level detect_simd_level()
+{
+#if defined(CVECTOR_SIMD_X86)
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4] = { 0 };
+
+        __cpuid(info, 1);
+        const bool hasSse42   = (info[2] & (1 << 20)) != 0;
+        const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+        const bool hasAvx     = (info[2] & (1 << 28)) != 0;
+
+        // check if OS saves YMM registers
+        const bool osYmm = hasOsxsave && hasAvx && ((_xgetbv(0) & 6) == 6);
+
+        __cpuidex(info, 7, 0);
+        const bool hasAvx2 = osYmm && ((info[1] & (1 << 5)) != 0);
+    #else
+        __builtin_cpu_init();
+        const bool hasSse42 = __builtin_cpu_supports("sse4.2");
+        const bool hasAvx2  = __builtin_cpu_supports("avx2");
+    #endif
+
+    if (hasAvx2)  return simd_level::avx2;
+    if (hasSse42) return simd_level::sse42;
+#endif
+
+    return simd_level::scalar;
+}
+
+// ----------------------------------------------------
+
+inline simd_level get_simd_level()
+{
+    static const simd_level level = detect_simd_level();
+    return level;
+}
+
+// ----------------------------------------------------
+
+inline int ctz32(const uint32_t mask)
+{
+    // count trailing zeros (mask != 0)
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (int)idx;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+
+// =================================================================================
+// scalar kernels
+// =================================================================================
+template <typename T>
+inline ptrdiff_t find_scalar(const T* data, const ptrdiff_t n, const T& value)
+{
+    for (ptrdiff_t i = 0; i < n; ++i)
+    {
+        if (data[i] == value)
+            return i;
+    }
+
+    return -1;
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Pred>
+inline ptrdiff_t remove_if_scalar(T* data, const ptrdiff_t n, Pred& pred)
+{
+    // branchless compaction: each element is always written, but the write
+    // position moves forward only if the element is kept
+
+    ptrdiff_t dst = 0;
+
+    for (ptrdiff_t i = 0; i < n; ++i)
+    {
+        const T value = data[i];
+        data[dst] = value;
+        dst += !pred(value);
+    }
+
+    return dst;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+inline void prefetch_elem(const T* ptr)
+{
+    // prefetch each cache line of the element (but no more than 4 lines)
+    constexpr size_t numLines = std::min<size_t>((sizeof(T) + 63) / 64, 4);
+
+    for (size_t line = 0; line < numLines; ++line)
+        CVECTOR_PREFETCH((const char*)ptr + line * 64);
+}
+
+// ----------------------------------------------------
+
+inline bool is_consecutive(const ptrdiff_t* idxs, const ptrdiff_t count)
+{
+    // check if idxs are (idx, idx+1, idx+2...): without an early exit
+    // so the compiler vectorizes it
+
+    const ptrdiff_t first = idxs[0];
+    bool isRun = true;
+
+    for (ptrdiff_t k = 0; k < count; ++k)
+        isRun &= (idxs[k] == first + k);
+
+    return isRun;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+inline void gather_scalar(const T* src, const ptrdiff_t* idxs, const ptrdiff_t n, T* out)
+{
+    // out[i] = src[idxs[i]]; big elements are prefetched a few iterations ahead
+
+    for (ptrdiff_t i = 0; i < n; ++i)
+    {
+        if constexpr (sizeof(T) > 8)
+        {
+            if (i + gatherPrefetchDistance < n)
+                prefetch_elem(src + idxs[i + gatherPrefetchDistance]);
+        }
+
+        out[i] = src[idxs[i]];
+    }
+}
+
+// ----------------------------------------------------
+
+inline ptrdiff_t count_bits_scalar(const uint64_t* words, const ptrdiff_t n)
+{
+    ptrdiff_t count = 0;
+
+    for (ptrdiff_t i = 0; i < n; ++i)
+        count += std::popcount(words[i]);
+
+    return count;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+inline ptrdiff_t find_any_scalar(
+    const T* data,
+    const ptrdiff_t n,
+    const T* values,
+    const ptrdiff_t numValues)
+{
+    for (ptrdiff_t i = 0; i < n; ++i)
+    {
+        for (ptrdiff_t k = 0; k < numValues; ++k)
+        {
+            if (data[i] == values[k])
+                return i;
+        }
+    }
+
+    return -1;
+}
+
+
+#if defined(CVECTOR_SIMD_X86)
+
+// max number of values which are compared per one pass in find_any()
+constexpr int maxNeedlesPerPass = 4;
+
+// permutation table for stream compaction of 8 x 32-bit lanes:
+// for each 8-bit mask of kept lanes -- indices of these lanes packed into
+// nibbles (the first kept lane is in the lowest nibble)
+constexpr std::array<uint32_t, 256> make_compact_lut_32()
+{
+    std::array<uint32_t, 256> lut = {};
+
+    for (uint32_t mask = 0; mask < 256; ++mask)
+    {
+        uint32_t packed = 0;
+        uint32_t pos = 0;
+
+        for (uint32_t lane = 0; lane < 8; ++lane)
+        {
+            if (mask & (1u << lane))
+                packed |= lane << (4 * pos++);
+        }
+        lut[mask] = packed;
+    }
+
+    return lut;
+}
+
+// the same for 4 x 64-bit lanes: each kept 64-bit lane is a pair of 32-bit lanes
+constexpr std::array<uint32_t, 16> make_compact_lut_64()
+{
+    std::array<uint32_t, 16> lut = {};
+
+    for (uint32_t mask = 0; mask < 16; ++mask)
+    {
+        uint32_t packed = 0;
+        uint32_t pos = 0;
+
+        for (uint32_t lane = 0; lane < 4; ++lane)
+        {
+            if (mask & (1u << lane))
+            {
+                packed |= (2 * lane)     << (4 * pos++);
+                packed |= (2 * lane + 1) << (4 * pos++);
+            }
+        }
+        lut[mask] = packed;
+    }
+
+    return lut;
+}
+
+inline constexpr std::array<uint32_t, 256> compactLut32 = make_compact_lut_32();
+inline constexpr std::array<uint32_t, 16>  compactLut64 = make_compact_lut_64();
+
+// =================================================================================
+// AVX2 kernels
+// =================================================================================
+template <typename T>
+CVECTOR_TARGET_AVX2 inline uint32_t cmp_mask_avx2(const T* ptr, const __m256i needle)
+{
+    // compare 32 bytes of data with the needle and return a byte mask of equal lanes
+
+    using U = lane_t<T>;
+    const __m256i block = _mm256_loadu_si256((const __m256i*)ptr);
+
+    if constexpr (std::is_same_v<U, float>)
+        return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(block), _mm256_castsi256_ps(needle), _CMP_EQ_OQ));
+    else if constexpr (std::is_same_v<U, double>)
+        return (uint32_t)_mm256_movemask_pd(_mm256_cmp_pd(_mm256_castsi256_pd(block), _mm256_castsi256_pd(needle), _CMP_EQ_OQ));
+    else if constexpr (sizeof(U) == 1)
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+    else if constexpr (sizeof(U) == 2)
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(block, needle));
+    else if constexpr (sizeof(U) == 4)
+        return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle)));
+    else
+        return (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, needle)));
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+CVECTOR_TARGET_AVX2 inline __m256i broadcast_avx2(const T& value)
+{
+    using U = lane_t<T>;
+    U bits;
+    memcpy(&bits, &value, sizeof(U));
+
+    if constexpr (std::is_same_v<U, float>)
+        return _mm256_castps_si256(_mm256_set1_ps(bits));
+    else if constexpr (std::is_same_v<U, double>)
+        return _mm256_castpd_si256(_mm256_set1_pd(bits));
+    else if constexpr (sizeof(U) == 1)
+        return _mm256_set1_epi8((char)bits);
+    else if constexpr (sizeof(U) == 2)
+        return _mm256_set1_epi16((short)bits);
+    else if constexpr (sizeof(U) == 4)
+        return _mm256_set1_epi32((int)bits);
+    else
+        return _mm256_set1_epi64x((long long)bits);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+CVECTOR_TARGET_AVX2 ptrdiff_t find_avx2(const T* data, const ptrdiff_t n, const T& value)
+{
+    // mask bits per element: byte-masks for 1/2-byte lanes, lane-masks for 4/8-byte lanes
+    constexpr ptrdiff_t step        = 32 / sizeof(T);
+    constexpr int       bitsPerElem = (sizeof(T) <= 2) ? (int)sizeof(T) : 1;
+
+    const __m256i needle = broadcast_avx2(value);
+    ptrdiff_t i = 0;
+
+    // 2x unrolled: 64 bytes per iteration
+    for (; i + 2 * step <= n; i += 2 * step)
+    {
+        const uint32_t mask0 = cmp_mask_avx2(data + i, needle);
+        const uint32_t mask1 = cmp_mask_avx2(data + i + step, needle);
+
+        if (mask0 | mask1)
+        {
+            if (mask0)
+                return i + ctz32(mask0) / bitsPerElem;
+
+            return i + step + ctz32(mask1) / bitsPerElem;
+        }
+    }
+
+    for (; i + step <= n; i += step)
+    {
+        const uint32_t mask = cmp_mask_avx2(data + i, needle);
+
+        if (mask)
+            return i + ctz32(mask) / bitsPerElem;
+    }
+
+    // the tail
+    const ptrdiff_t idx = find_scalar(data + i, n - i, value);
+    return (idx < 0) ? -1 : i + idx;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+CVECTOR_TARGET_AVX2 ptrdiff_t find_any_avx2(
+    const T* data,
+    const ptrdiff_t n,
+    const T* values,
+    const int numValues)
+{
+    // check up to maxNeedlesPerPass values per one pass over data
+
+    constexpr ptrdiff_t step        = 32 / sizeof(T);
+    constexpr int       bitsPerElem = (sizeof(T) <= 2) ? (int)sizeof(T) : 1;
+
+    __m256i needles[maxNeedlesPerPass];
+    for (int k = 0; k < numValues; ++k)
+        needles[k] = broadcast_avx2(values[k]);
+
+    ptrdiff_t i = 0;
+
+    for (; i + step <= n; i += step)
+    {
+        uint32_t mask = 0;
+
+        for (int k = 0; k < numValues; ++k)
+            mask |= cmp_mask_avx2(data + i, needles[k]);
+
+        if (mask)
+            return i + ctz32(mask) / bitsPerElem;
+    }
+
+    // the tail
+    const ptrdiff_t idx = find_any_scalar(data + i, n - i, values, numValues);
+    return (idx < 0) ? -1 : i + idx;
+}
+
+
+// ----------------------------------------------------
+
+template <typename T, typename Pred>
+CVECTOR_TARGET_AVX2 ptrdiff_t remove_if_avx2(T* data, const ptrdiff_t n, Pred& pred)
+{
+    // stream compaction for elements of 4 or 8 bytes: compute a mask of kept
+    // elements for a block of 32 bytes, pack the kept ones into the lowest lanes
+    // with a single permutation and store the whole block;
+    // NOTE: it is safe in-place: we store into [dst, dst+32 bytes) where dst <= i
+    //       so we overwrite only the elements which are already loaded
+
+    static_assert((sizeof(T) == 4) || (sizeof(T) == 8));
+
+    constexpr ptrdiff_t step = 32 / sizeof(T);
+    const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    const __m256i nibble = _mm256_set1_epi32(0xF);
+
+    ptrdiff_t dst = 0;
+    ptrdiff_t i   = 0;
+
+    for (; i + step <= n; i += step)
+    {
+        uint32_t keepMask = 0;
+
+        for (ptrdiff_t lane = 0; lane < step; ++lane)
+            keepMask |= (uint32_t)!pred(data[i + lane]) << lane;
+
+        const uint32_t packed = (sizeof(T) == 4) ? compactLut32[keepMask] : compactLut64[keepMask];
+        const __m256i  perm   = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)packed), shifts), nibble);
+        const __m256i  block  = _mm256_loadu_si256((const __m256i*)(data + i));
+
+        _mm256_storeu_si256((__m256i*)(data + dst), _mm256_permutevar8x32_epi32(block, perm));
+        dst += std::popcount(keepMask);
+    }
+
+    // the tail
+    for (; i < n; ++i)
+    {
+        const T value = data[i];
+        data[dst] = value;
+        dst += !pred(value);
+    }
+
+    return dst;
+}
+
+
+// ----------------------------------------------------
+
+template <typename T>
+CVECTOR_TARGET_AVX2 void gather_avx2(const T* src, const ptrdiff_t* idxs, const ptrdiff_t n, T* out)
+{
+    // gather 4 elements of 4 or 8 bytes per instruction (by 4 x 64-bit idxs)
+
+    static_assert(((sizeof(T) == 4) || (sizeof(T) == 8)) && (sizeof(ptrdiff_t) == 8));
+
+    ptrdiff_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i vIdxs = _mm256_loadu_si256((const __m256i*)(idxs + i));
+
+        if constexpr (sizeof(T) == 4)
+        {
+            const __m128i values = _mm256_i64gather_epi32((const int*)src, vIdxs, 4);
+            _mm_storeu_si128((__m128i*)(out + i), values);
+        }
+        else
+        {
+            const __m256i values = _mm256_i64gather_epi64((const long long*)src, vIdxs, 8);
+            _mm256_storeu_si256((__m256i*)(out + i), values);
+        }
+    }
+
+    // the tail
+    for (; i < n; ++i)
+        out[i] = src[idxs[i]];
+}
+
+
+// =================================================================================
+// SSE4.2 kernels
+// =================================================================================
+template <typename T>
+CVECTOR_TARGET_SSE42 inline uint32_t cmp_mask_sse42(const T* ptr, const __m128i needle)
+{
+    // compare 16 bytes of data with the needle and return a mask of equal lanes
+
+    using U = lane_t<T>;
+    const __m128i block = _mm_loadu_si128((const __m128i*)ptr);
+
+    if constexpr (std::is_same_v<U, float>)
+        return (uint32_t)_mm_movemask_ps(_mm_cmpeq_ps(_mm_castsi128_ps(block), _mm_castsi128_ps(needle)));
+    else if constexpr (std::is_same_v<U, double>)
+        return (uint32_t)_mm_movemask_pd(_mm_cmpeq_pd(_mm_castsi128_pd(block), _mm_castsi128_pd(needle)));
+    else if constexpr (sizeof(U) == 1)
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+    else if constexpr (sizeof(U) == 2)
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(block, needle));
+    else if constexpr (sizeof(U) == 4)
+        return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+    else
+        return (uint32_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(block, needle)));
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+CVECTOR_TARGET_SSE42 inline __m128i broadcast_sse42(const T& value)
+{
+    using U = lane_t<T>;
+    U bits;
+    memcpy(&bits, &value, sizeof(U));
+
+    if constexpr (std::is_same_v<U, float>)
+        return _mm_castps_si128(_mm_set1_ps(bits));
+    else if constexpr (std::is_same_v<U, double>)
+        return _mm_castpd_si128(_mm_set1_pd(bits));
+    else if constexpr (sizeof(U) == 1)
+        return _mm_set1_epi8((char)bits);
+    else if constexpr (sizeof(U) == 2)
+        return _mm_set1_epi16((short)bits);
+    else if constexpr (sizeof(U) == 4)
+        return _mm_set1_epi32((int)bits);
+    else
+        return _mm_set1_epi64x((long long)bits);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+CVECTOR_TARGET_SSE42 ptrdiff_t find_sse42(const T* data, const ptrdiff_t n, const T& value)
+{
+    constexpr ptrdiff_t step        = 16 / sizeof(T);
+    constexpr int       bitsPerElem = (sizeof(T) <= 2) ? (int)sizeof(T) : 1;
+
+    const __m128i needle = broadcast_sse42(value);
+    ptrdiff_t i = 0;
+
+    for (; i + step <= n; i += step)
+    {
+        const uint32_t mask = cmp_mask_sse42(data + i, needle);
+
+        if (mask)
+            return i + ctz32(mask) / bitsPerElem;
+    }
+
+    // the tail
+    const ptrdiff_t idx = find_scalar(data + i, n - i, value);
+    return (idx < 0) ? -1 : i + idx;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+CVECTOR_TARGET_SSE42 ptrdiff_t find_any_sse42(
+    const T* data,
+    const ptrdiff_t n,
+    const T* values,
+    const int numValues)
+{
+    constexpr ptrdiff_t step        = 16 / sizeof(T);
+    constexpr int       bitsPerElem = (sizeof(T) <= 2) ? (int)sizeof(T) : 1;
+
+    __m128i needles[maxNeedlesPerPass];
+    for (int k = 0; k < numValues; ++k)
+        needles[k] = broadcast_sse42(values[k]);
+
+    ptrdiff_t i = 0;
+
+    for (; i + step <= n; i += step)
+    {
+        uint32_t mask = 0;
+
+        for (int k = 0; k < numValues; ++k)
+            mask |= cmp_mask_sse42(data + i, needles[k]);
+
+        if (mask)
+            return i + ctz32(mask) / bitsPerElem;
+    }
+
+    // the tail
+    const ptrdiff_t idx = find_any_scalar(data + i, n - i, values, numValues);
+    return (idx < 0) ? -1 : i + idx;
+}
+
+// ----------------------------------------------------
+
+CVECTOR_TARGET_SSE42 inline ptrdiff_t count_bits_popcnt(const uint64_t* words, const ptrdiff_t n)
+{
+    // SSE4.2 CPUs have the popcnt instruction; 4 independent accumulators
+    // hide its latency so it runs at a word per cycle
+
+    ptrdiff_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    ptrdiff_t i  = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        c0 += std::popcount(words[i + 0]);
+        c1 += std::popcount(words[i + 1]);
+        c2 += std::popcount(words[i + 2]);
+        c3 += std::popcount(words[i + 3]);
+    }
+
+    for (; i < n; ++i)
+        c0 += std::popcount(words[i]);
+
+    return c0 + c1 + c2 + c3;
+}
+
+#endif // CVECTOR_SIMD_X86
+
+
+// =================================================================================
+// public entry points (T must satisfy is_searchable_v<T>)
+// =================================================================================
+template <typename T>
+inline ptrdiff_t find(const T* data, const ptrdiff_t n, const T& value)
+{
+    // return index of the first element which is equal to value, or -1
+
+#if defined(CVECTOR_SIMD_X86)
+    switch (get_simd_level())
+    {
+        case simd_level::avx2:  return find_avx2(data, n, value);
+        case simd_level::sse42: return find_sse42(data, n, value);
+        default:                break;
+    }
+#endif
+
+    return find_scalar(data, n, value);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+ptrdiff_t find_any(
+    const T* data,
+    const ptrdiff_t n,
+    const T* values,
+    const ptrdiff_t numValues)
+{
+    // return index of the first element which is equal to any of values, or -1
+
+#if defined(CVECTOR_SIMD_X86)
+    const simd_level level = get_simd_level();
+
+    if (level != simd_level::scalar)
+    {
+        ptrdiff_t found = -1;
+        ptrdiff_t end   = n;
+
+        // each pass checks a group of values; the next passes only
+        // need to scan the data before the best found index so far
+        for (ptrdiff_t k = 0; k < numValues; k += maxNeedlesPerPass)
+        {
+            const int numNeedles = (int)std::min<ptrdiff_t>(maxNeedlesPerPass, numValues - k);
+            const ptrdiff_t idx = (level == simd_level::avx2) ?
+                find_any_avx2(data, end, values + k, numNeedles) :
+                find_any_sse42(data, end, values + k, numNeedles);
+
+            if (idx >= 0)
+            {
+                found = idx;
+                end   = idx;
+            }
+        }
+
+        return found;
+    }
+#endif
+
+    return find_any_scalar(data, n, values, numValues);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+inline void gather(const T* src, const ptrdiff_t* idxs, const ptrdiff_t n, T* out)
+{
+    // out[i] = src[idxs[i]] for i in [0, n) (T must satisfy is_bytewise_copyable_v<T>):
+    // blocks of consecutive idxs are copied with memcpy, the rest is gathered
+    // with AVX2 (for 4/8-byte elements) or one by one
+
+    constexpr ptrdiff_t blockSize = gatherBlockSize<T>;
+
+#if defined(CVECTOR_SIMD_X86)
+    constexpr bool canUseAvx2 = ((sizeof(T) == 4) || (sizeof(T) == 8)) && (sizeof(ptrdiff_t) == 8);
+    const bool     useAvx2    = canUseAvx2 && (get_simd_level() == simd_level::avx2);
+#endif
+
+    for (ptrdiff_t i = 0; i < n; i += blockSize)
+    {
+        const ptrdiff_t count = std::min(blockSize, n - i);
+
+        // the cheap check first: the last idx is where it should be for a run
+        if ((count == blockSize) &&
+            (idxs[i + count - 1] - idxs[i] == count - 1) &&
+            is_consecutive(idxs + i, count))
+        {
+            memcpy((void*)(out + i), src + idxs[i], count * sizeof(T));
+            continue;
+        }
+
+#if defined(CVECTOR_SIMD_X86)
+        if constexpr (canUseAvx2)
+        {
+            if (useAvx2)
+            {
+                gather_avx2(src, idxs + i, count, out + i);
+                continue;
+            }
+        }
+#endif
+
+        gather_scalar(src, idxs + i, count, out + i);
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, typename Pred>
+inline ptrdiff_t remove_if(T* data, const ptrdiff_t n, Pred& pred)
+{
+    // remove elements for which pred returns true, keep the order of the rest;
+    // return the number of kept elements (T must satisfy is_bytewise_copyable_v<T>)
+
+#if defined(CVECTOR_SIMD_X86)
+    if constexpr ((sizeof(T) == 4) || (sizeof(T) == 8))
+    {
+        if (get_simd_level() == simd_level::avx2)
+            return remove_if_avx2(data, n, pred);
+    }
+#endif
+
+    return remove_if_scalar(data, n, pred);
+}
+
+// ----------------------------------------------------
+
+inline ptrdiff_t count_bits(const uint64_t* words, const ptrdiff_t n)
+{
+    // return the number of set bits in n words
+
+#if defined(CVECTOR_SIMD_X86)
+    if (get_simd_level() != simd_level::scalar)
+        return count_bits_popcnt(words, n);
+#endif
+
+    return count_bits_scalar(words, n);
+}
+
+} // namespace cvector_simd
@@ -0,0 +1,245 @@
+// =================================================================================
+// Filename:     cvector_soa.h
+// Description:  structure-of-arrays container: each field of a row is stored
+//               in its own contiguous column (cvector) so a system which touches
+//               only one field streams only this field through the cache;
+//
+//               row-wise operations (push_back, erase, insert_before, resize,
+//               reserve, etc.) are applied to all the columns at once, and all
+//               the columns share a single capacity and growth policy;
+//               columns are accessed by their number:
+//
+//                   cvector_soa<EntityID, XMFLOAT3, XMFLOAT4> transforms;
+//                   transforms.push_back(id, pos, rot);
+//                   for (XMFLOAT3& pos : transforms.column<1>()) ...
+//                   const index i = transforms.column<0>().get_idx(id);   // full cvector API (const)
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+#include "cvector_span.h"
+#include <tuple>
+
+
+template <typename Growth, typename... Ts>
+class basic_cvector_soa
+{
+    static_assert(sizeof...(Ts) > 0, "cvector_soa: at least one column is required");
+    static_assert(cvector_growth::growth_policy<Growth>, "cvector_soa: Growth must have static grow(capacity, required, elemSize)");
+
+public:
+    template <size_t I>
+    using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    static constexpr size_t num_columns = sizeof...(Ts);
+    static constexpr size_t row_size    = (sizeof(Ts) + ...);    // bytes of all the fields of a row
+
+    basic_cvector_soa() {}
+    explicit basic_cvector_soa(const vsize count) { resize(count); }
+
+
+    // columns: mutable access to elements (the size of columns can't be changed
+    // separately) or read-only access to the whole cvector API
+    template <size_t I> cvector_span<column_type<I>>      column()       { return cvector_span<column_type<I>>(std::get<I>(columns_).begin(), size()); }
+    template <size_t I> const cvector<column_type<I>>&    column() const { return std::get<I>(columns_); }
+
+    template <size_t I> column_type<I>*                   data()         { return std::get<I>(columns_).begin(); }
+    template <size_t I> const column_type<I>*             data()   const { return std::get<I>(columns_).data(); }
+
+    template <size_t I> column_type<I>&                   get(const index i)       { return std::get<I>(columns_)[i]; }
+    template <size_t I> const column_type<I>&             get(const index i) const { return std::get<I>(columns_)[i]; }
+
+
+    // getters
+    inline bool  empty()                 const { return size() == 0; }
+    inline vsize size()                  const { return std::get<0>(columns_).size(); }
+    inline vsize capacity()              const { return capacity_; }
+    inline bool  is_valid_index(index i) const { return (i >= 0) && (i < size()); }
+
+    // gather values of the column I by indices
+    template <size_t I, typename IdxAlloc, typename OutAlloc>
+    void get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, cvector<column_type<I>, OutAlloc>& outData) const
+    {
+        std::get<I>(columns_).get_data_by_idxs(idxs, outData);
+    }
+
+    template <size_t I, typename IdxAlloc>
+    void get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, column_type<I>* outData) const
+    {
+        std::get<I>(columns_).get_data_by_idxs(idxs, outData);
+    }
+
+
+    // setters (row-wise)
+    void  push_back(const Ts&... values);
+    void  pop_back();
+    void  clear();
+    void  erase(const index idx);
+    vsize erase_idxs(const index* sortedIdxs, const vsize numIdxs);
+    void  insert_before(const index idx, const Ts&... values);
+
+    // allocators
+    void  reserve(const vsize newCapacity);
+    void  resize(const vsize newSize);
+    void  shrink_to_fit();
+    void  purge();
+
+private:
+    // apply a function to each column
+    template <typename Func>
+    void for_each_column(Func&& func)
+    {
+        std::apply([&](auto&... cols) { (func(cols), ...); }, columns_);
+    }
+
+    void grow_for(const vsize required);
+
+    std::tuple<cvector<Ts>...> columns_;
+    vsize                      capacity_ = 0;
+};
+
+
+// structure-of-arrays with the default growth policy
+template <typename... Ts>
+using cvector_soa = basic_cvector_soa<default_growth, Ts...>;
+
+
+// =================================================================================
+//                              setters (row-wise)
+// =================================================================================
+template <typename Growth, typename... Ts>
+void basic_cvector_soa<Growth, Ts...>::push_back(const Ts&... values)
+{
+    grow_for(size() + 1);
+
+    std::apply([&](auto&... cols) { (cols.push_back(values), ...); }, columns_);
+}
+
+// ----------------------------------------------------
+
+template <typename Growth, typename... Ts>
+inline void basic_cvector_soa<Growth, Ts...>::pop_back()
+{
+    for_each_column([](auto& col) { col.pop_back(); });
+}
+
+// ----------------------------------------------------
+
+template <typename Growth, typename... Ts>
+inline void basic_cvector_soa<Growth, Ts...>::clear()
+{
+    // destroy all the rows but keep the capacity
+    for_each_column([](auto& col) { col.clear(); });
+}
+
+// ----------------------------------------------------
+
+template <typename Growth, typename... Ts>
+void basic_cvector_soa<Growth, Ts...>::erase(const index idx)
+{
+    if constexpr (ENABLE_CHECK)
+    {
+        if (!is_valid_index(idx))
+        {
+            cvector_io::print_error("cvector_soa::erase()", "invalid input args");
+            return;
+        }
+    }
+
+    for_each_column([idx](auto& col) { col.erase(idx); });
+}
+
+// ----------------------------------------------------
+
+template <typename Growth, typename... Ts>
+vsize basic_cvector_soa<Growth, Ts...>::erase_idxs(const index* sortedIdxs, const vsize numIdxs)
+{
+    // remove rows by SORTED indices (duplicates are allowed) in a single pass over each column;
+    // return the number of erased rows
+
+    const vsize oldSize = size();
+    for_each_column([=](auto& col) { col.erase_idxs(sortedIdxs, numIdxs); });
+
+    return oldSize - size();
+}
+
+// ----------------------------------------------------
+
+template <typename Growth, typename... Ts>
+void basic_cvector_soa<Growth, Ts...>::insert_before(const index idx, const Ts&... values)
+{
+    // insert a row so it will be right at idx (the rest of rows shift right)
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((idx < 0) | (idx > size()))
+        {
+            cvector_io::print_error("cvector_soa::insert_before()", "invalid input args");
+            return;
+        }
+    }
+
+    grow_for(size() + 1);
+
+    std::apply([&](auto&... cols) { (cols.insert_before(idx, values), ...); }, columns_);
+}
+
+
+// =================================================================================
+//                          change size / capacity
+// =================================================================================
+template <typename Growth, typename... Ts>
+void basic_cvector_soa<Growth, Ts...>::reserve(const vsize newCapacity)
+{
+    // only raw memory is allocated for each column, no rows are constructed
+
+    if (capacity_ >= newCapacity)
+        return;
+
+    for_each_column([newCapacity](auto& col) { col.reserve(newCapacity); });
+    capacity_ = newCapacity;
+}
+
+// ----------------------------------------------------
+
+template <typename Growth, typename... Ts>
+void basic_cvector_soa<Growth, Ts...>::resize(const vsize newSize)
+{
+    // new rows (if any) are value-initialized
+
+    reserve(newSize);
+    for_each_column([newSize](auto& col) { col.resize(newSize); });
+}
+
+// ----------------------------------------------------
+
+template <typename Growth, typename... Ts>
+void basic_cvector_soa<Growth, Ts...>::shrink_to_fit()
+{
+    for_each_column([](auto& col) { col.shrink_to_fit(); });
+    capacity_ = size();
+}
+
+// ----------------------------------------------------
+
+template <typename Growth, typename... Ts>
+void basic_cvector_soa<Growth, Ts...>::purge()
+{
+    // destroy all the rows and release memory of all the columns
+    for_each_column([](auto& col) { col.purge(); });
+    capacity_ = 0;
+}
+
+
+// =================================================================================
+//                              private methods
+// =================================================================================
+template <typename Growth, typename... Ts>
+inline void basic_cvector_soa<Growth, Ts...>::grow_for(const vsize required)
+{
+    // grow all the columns at once according to the growth policy
+    // (the growth step is computed for the whole row)
+
+    if (capacity_ < required)
+        reserve((vsize)Growth::grow(capacity_, required, row_size));
+}
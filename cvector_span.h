@@ -0,0 +1,278 @@
+// =================================================================================
+// Filename:     cvector_span.h
+// Description:  non-owning view (pointer + size) of contiguous elements which
+//               are owned by anything else (cvector or its subrange, frozen_cvector,
+//               cvector_view, std::vector, a raw array) with all the read-only
+//               algorithms of cvector: find, find_any, has_value, get_idx,
+//               get_insert_idx(s), get_idxs, binary_search, get_data_by_idxs;
+//
+//               batched methods write into caller-provided spans so they don't
+//               allocate anything (output spans must be big enough);
+//
+//               cvector_span<const T> is read-only, cvector_span<T> lets to
+//               change elements (so it's used for outputs as well)
+//
+//               usage:
+//                   cvector_span<const int> ids(sortedIds);
+//                   index outIdxs[256];
+//                   ids.subspan(0, 1000).get_idxs(queries, cvector_span<index>(outIdxs));
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+
+
+template <typename T>
+class cvector_span
+{
+public:
+    using value_type = std::remove_cv_t<T>;
+
+    constexpr cvector_span() {}
+    constexpr cvector_span(T* data, const vsize size) : data_(data), size_(size) {}
+
+    template <size_t N>
+    constexpr cvector_span(T (&arr)[N]) : data_(arr), size_((vsize)N) {}
+
+    // any contiguous container: cvector, frozen_cvector, cvector_view, std::vector, std::array, etc.
+    template <typename Container>
+        requires requires(Container& c) { { c.data() } -> std::convertible_to<T*>; c.size(); }
+    constexpr cvector_span(Container& c) : data_(c.data()), size_((vsize)c.size()) {}
+
+    template <typename Container>
+        requires requires(const Container& c) { { c.data() } -> std::convertible_to<T*>; c.size(); }
+    constexpr cvector_span(const Container& c) : data_(c.data()), size_((vsize)c.size()) {}
+
+    // a span of non-const elements converts to a span of const ones
+    template <typename U>
+        requires std::is_same_v<const U, T>
+    constexpr cvector_span(const cvector_span<U>& other) : data_(other.data()), size_(other.size()) {}
+
+
+    // getters
+    constexpr T&    operator[](index i)        const { return data_[i]; }
+
+    constexpr T*    begin()                    const { return data_; }
+    constexpr T*    end()                      const { return data_ + size_; }
+    constexpr T*    data()                     const { return data_; }
+    constexpr bool  empty()                    const { return size_ == 0; }
+    constexpr vsize size()                     const { return size_; }
+    constexpr bool  is_valid_index(index i)    const { return (i >= 0) && (i < size_); }
+
+    // subranges (without checks, as operator[])
+    constexpr cvector_span subspan(const index offset, const vsize count) const { return { data_ + offset, count }; }
+    constexpr cvector_span first(const vsize count)                       const { return { data_, count }; }
+    constexpr cvector_span last(const vsize count)                        const { return { data_ + size_ - count, count }; }
+
+
+    // search in random data
+    index find(const value_type& value) const;
+    index find_any(cvector_span<const value_type> values) const;
+    bool  has_value(const value_type& value) const { return find(value) != -1; }
+
+    // search in sorted data (the same semantic as cvector)
+    constexpr index get_idx(const value_type& value) const;
+    constexpr index get_insert_idx(const value_type& value) const;
+    constexpr bool  binary_search(const value_type& value) const;
+
+    // batched search in sorted data: outputs must have at least values.size() elements
+    void get_idxs(
+        cvector_span<const value_type> values,
+        cvector_span<index> outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    void get_insert_idxs(
+        cvector_span<const value_type> values,
+        cvector_span<index> outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    bool binary_search(cvector_span<const value_type> values) const;
+
+    void binary_search(
+        cvector_span<const value_type> values,
+        cvector_span<bool> outFlags,
+        const query_order order = query_order::unknown) const;
+
+    // out[i] = (*this)[idxs[i]]: output must have at least idxs.size() elements
+    void get_data_by_idxs(cvector_span<const index> idxs, cvector_span<value_type> outData) const;
+
+private:
+    // cvector's search/gather helpers
+    using vec_type = cvector<value_type>;
+
+    T*    data_ = nullptr;
+    vsize size_ = 0;
+};
+
+
+// =================================================================================
+//                              search (random data)
+// =================================================================================
+template <typename T>
+index cvector_span<T>::find(const value_type& value) const
+{
+    // find the first matching value and return its index (or -1)
+
+    if constexpr (cvector_simd::is_searchable_v<value_type>)
+    {
+        return cvector_simd::find((const value_type*)data_, size_, value);
+    }
+    else
+    {
+        const T* it = std::find(begin(), end(), value);
+        return (it != end()) ? (index)(it - begin()) : -1;
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+index cvector_span<T>::find_any(cvector_span<const value_type> values) const
+{
+    // find the first element which is equal to any of input values (or -1)
+
+    if constexpr (cvector_simd::is_searchable_v<value_type>)
+    {
+        return cvector_simd::find_any((const value_type*)data_, size_, values.data(), values.size());
+    }
+    else
+    {
+        const T* it = std::find_first_of(begin(), end(), values.begin(), values.end());
+        return (it != end()) ? (index)(it - begin()) : -1;
+    }
+}
+
+
+// =================================================================================
+//                              search (sorted data)
+// =================================================================================
+template <typename T>
+constexpr index cvector_span<T>::get_idx(const value_type& value) const
+{
+    // NOTE: the span must be SORTED!
+    return vec_type::upper_bound_ptr(begin(), end(), value) - begin() - 1;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+constexpr index cvector_span<T>::get_insert_idx(const value_type& value) const
+{
+    // position for sorted insertion (after all the equal values)
+    return vec_type::upper_bound_ptr(begin(), end(), value) - begin();
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+constexpr bool cvector_span<T>::binary_search(const value_type& value) const
+{
+    // NOTE: the span must be SORTED!
+    return vec_type::binary_search_ptr(begin(), end(), value);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+void cvector_span<T>::get_idxs(
+    cvector_span<const value_type> values,
+    cvector_span<index> outIdxs,
+    const query_order order) const
+{
+    // NOTE: the span must be SORTED!
+    // out: lower bound idx for each input value
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if (outIdxs.size() < values.size())
+        {
+            cvector_io::print_error("cvector_span::get_idxs()", "output span is too small");
+            return;
+        }
+    }
+
+    vec_type::template get_bound_idxs<false>(begin(), end(), values.data(), values.size(), outIdxs.data(), order);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+void cvector_span<T>::get_insert_idxs(
+    cvector_span<const value_type> values,
+    cvector_span<index> outIdxs,
+    const query_order order) const
+{
+    // NOTE: the span must be SORTED!
+    // out: position for sorted insertion of each input value
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if (outIdxs.size() < values.size())
+        {
+            cvector_io::print_error("cvector_span::get_insert_idxs()", "output span is too small");
+            return;
+        }
+    }
+
+    vec_type::template get_bound_idxs<true>(begin(), end(), values.data(), values.size(), outIdxs.data(), order);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+bool cvector_span<T>::binary_search(cvector_span<const value_type> values) const
+{
+    // NOTE: the span must be SORTED!
+    // check if all the input values exist (value i is searched in range [b+i, e)
+    // as cvector::binary_search() does)
+
+    bool isExist = true;
+
+    for (index i = 0; i < values.size(); ++i)
+        isExist &= vec_type::binary_search_ptr(begin() + i, end(), values[i]);
+
+    return isExist;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+void cvector_span<T>::binary_search(
+    cvector_span<const value_type> values,
+    cvector_span<bool> outFlags,
+    const query_order order) const
+{
+    // NOTE: the span must be SORTED!
+    // out: existence flag for each input value
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if (outFlags.size() < values.size())
+        {
+            cvector_io::print_error("cvector_span::binary_search()", "output span is too small");
+            return;
+        }
+    }
+
+    const bool isSorted = vec_type::is_sorted_batch(values.data(), values.size(), order);
+    vec_type::search_flags(begin(), end(), values.data(), 0, values.size(), outFlags.data(), isSorted);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+void cvector_span<T>::get_data_by_idxs(cvector_span<const index> idxs, cvector_span<value_type> outData) const
+{
+    // NOTE: idxs must be valid
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if (outData.size() < idxs.size())
+        {
+            cvector_io::print_error("cvector_span::get_data_by_idxs()", "output span is too small");
+            return;
+        }
+    }
+
+    vec_type::gather_idxs(data_, idxs.data(), idxs.size(), outData.data());
+}
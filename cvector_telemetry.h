@@ -0,0 +1,335 @@
+// =================================================================================
+// Filename:     cvector_telemetry.h
+// Description:  allocation telemetry of cvector: counts buffer allocations,
+//               reallocations, bytes moved on growth, peak capacity and slack
+//               (unused capacity of released buffers) per element type and
+//               per call site of reserve/push_back/resize;
+//
+//               it is turned off by default, to turn it on define
+//               CVECTOR_ENABLE_TELEMETRY=1 for the WHOLE project (it changes
+//               the signatures of cvector methods); when it is off all the
+//               hooks are compiled out, call sites are empty structs and the
+//               registry (with its std::map/std::mutex) isn't even included
+//
+//               usage:
+//                   cvector_telemetry::set_realloc_hook(myHook);
+//                   ...
+//                   cvector_telemetry::dump_report();   // the most reallocating sites
+// =================================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+#ifndef CVECTOR_ENABLE_TELEMETRY
+    #define CVECTOR_ENABLE_TELEMETRY 0
+#endif
+
+#if CVECTOR_ENABLE_TELEMETRY
+    #include <algorithm>
+    #include <atomic>
+    #include <map>
+    #include <mutex>
+    #include <source_location>
+    #include <string>
+    #include <tuple>
+    #include <typeinfo>
+    #include <vector>
+#endif
+
+
+namespace cvector_telemetry
+{
+
+constexpr bool ENABLE_TELEMETRY = (CVECTOR_ENABLE_TELEMETRY != 0);
+
+// call site which is used instead of std::source_location when telemetry is off
+struct no_call_site
+{
+    static constexpr no_call_site current() noexcept { return {}; }
+
+    constexpr const char*   file_name()     const noexcept { return ""; }
+    constexpr const char*   function_name() const noexcept { return ""; }
+    constexpr uint_least32_t line()         const noexcept { return 0; }
+};
+
+#if CVECTOR_ENABLE_TELEMETRY
+using call_site = std::source_location;
+#else
+using call_site = no_call_site;
+#endif
+
+
+// =================================================================================
+// STATS
+// =================================================================================
+struct alloc_stats
+{
+    uint64_t numAllocs      = 0;    // allocated buffers
+    uint64_t numReallocs    = 0;    // ... which replaced an existing buffer
+    uint64_t bytesAllocated = 0;
+    uint64_t bytesMoved     = 0;    // alive elements relocated into new buffers
+    uint64_t peakCapacity   = 0;    // the biggest buffer (in elements)
+    uint64_t numReleases    = 0;    // released buffers
+    uint64_t slackBytes     = 0;    // unused capacity of the released buffers (per site: of buffers allocated there)
+};
+
+// is passed to the realloc hook each time a buffer with elements is replaced
+struct realloc_event
+{
+    const char* typeName;
+    size_t      elemSize;
+    ptrdiff_t   oldCapacity;
+    ptrdiff_t   newCapacity;
+    ptrdiff_t   numMoved;           // number of relocated elements
+    const char* file;
+    const char* func;
+    unsigned    line;
+};
+
+using realloc_hook = void (*)(const realloc_event& e);
+
+
+#if CVECTOR_ENABLE_TELEMETRY
+
+struct site_stats
+{
+    std::string  typeName;
+    std::string  file;
+    std::string  func;
+    unsigned     line = 0;
+    alloc_stats  stats;
+};
+
+
+// =================================================================================
+// REGISTRY
+// =================================================================================
+namespace detail
+{
+
+using site_key = std::tuple<std::string, std::string, std::string, unsigned>;  // type, file, func, line
+
+struct registry
+{
+    std::mutex                          mutex;
+    std::map<std::string, alloc_stats>  types;
+    std::map<site_key, alloc_stats>     sites;
+    std::atomic<realloc_hook>           hook{ nullptr };
+};
+
+inline registry& get_registry()
+{
+    // never destroyed: vectors which are static objects themselves
+    // still can release their buffers after exit from main()
+    static registry* reg = new registry;
+    return *reg;
+}
+
+} // namespace detail
+
+// ----------------------------------------------------
+
+template <typename T>
+void on_alloc(const call_site& site, const ptrdiff_t oldCapacity, const ptrdiff_t newCapacity, const ptrdiff_t numMoved)
+{
+    // a new buffer of newCapacity elements is allocated (and replaces
+    // the old buffer of oldCapacity elements if there was any)
+
+    detail::registry& reg = detail::get_registry();
+    const bool isRealloc  = (oldCapacity > 0);
+
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        alloc_stats& typeStats = reg.types[typeid(T).name()];
+        alloc_stats& siteStats = reg.sites[detail::site_key(typeid(T).name(), site.file_name(), site.function_name(), site.line())];
+
+        for (alloc_stats* s : { &typeStats, &siteStats })
+        {
+            s->numAllocs++;
+            s->numReallocs    += isRealloc;
+            s->bytesAllocated += (uint64_t)newCapacity * sizeof(T);
+            s->bytesMoved     += (uint64_t)numMoved * sizeof(T);
+            s->peakCapacity    = std::max(s->peakCapacity, (uint64_t)newCapacity);
+        }
+    }
+
+    const realloc_hook hook = reg.hook.load(std::memory_order_acquire);
+
+    if (isRealloc && hook)
+    {
+        hook(realloc_event{
+            typeid(T).name(), sizeof(T),
+            oldCapacity, newCapacity, numMoved,
+            site.file_name(), site.function_name(), (unsigned)site.line() });
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+void on_release(const call_site& allocSite, const ptrdiff_t capacity, const ptrdiff_t size)
+{
+    // a buffer of capacity elements where only size were alive is released;
+    // its slack is attributed to the site which allocated the buffer
+
+    detail::registry& reg = detail::get_registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    alloc_stats& typeStats = reg.types[typeid(T).name()];
+    alloc_stats& siteStats = reg.sites[detail::site_key(typeid(T).name(), allocSite.file_name(), allocSite.function_name(), allocSite.line())];
+
+    for (alloc_stats* s : { &typeStats, &siteStats })
+    {
+        s->numReleases++;
+        s->slackBytes += (uint64_t)(capacity - size) * sizeof(T);
+    }
+}
+
+
+// =================================================================================
+// PUBLIC API
+// =================================================================================
+
+// set a callback which is fired on each reallocation (return the previous one)
+inline realloc_hook set_realloc_hook(const realloc_hook hook)
+{
+    return detail::get_registry().hook.exchange(hook, std::memory_order_acq_rel);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+alloc_stats get_type_stats()
+{
+    detail::registry& reg = detail::get_registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    const auto it = reg.types.find(typeid(T).name());
+    return (it != reg.types.end()) ? it->second : alloc_stats{};
+}
+
+// ----------------------------------------------------
+
+inline std::vector<site_stats> get_site_stats()
+{
+    // stats of all the call sites sorted by the number of reallocations (desc)
+
+    detail::registry& reg = detail::get_registry();
+    std::vector<site_stats> result;
+
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        result.reserve(reg.sites.size());
+
+        for (const auto& [key, stats] : reg.sites)
+            result.push_back(site_stats{ std::get<0>(key), std::get<1>(key), std::get<2>(key), std::get<3>(key), stats });
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const site_stats& a, const site_stats& b)
+    {
+        if (a.stats.numReallocs != b.stats.numReallocs)
+            return a.stats.numReallocs > b.stats.numReallocs;
+        return a.stats.bytesMoved > b.stats.bytesMoved;
+    });
+
+    return result;
+}
+
+// ----------------------------------------------------
+
+inline void reset()
+{
+    detail::registry& reg = detail::get_registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    reg.types.clear();
+    reg.sites.clear();
+}
+
+// ----------------------------------------------------
+
+inline void dump_report(FILE* out = stdout, const size_t maxSites = 20)
+{
+    // print stats per element type and the call sites with the most
+    // reallocations: these are candidates for reserve() in advance
+
+    if (!out)
+        return;
+
+    std::vector<std::pair<std::string, alloc_stats>> types;
+    {
+        detail::registry& reg = detail::get_registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        types.assign(reg.types.begin(), reg.types.end());
+    }
+
+    fprintf(out, "\n=== cvector telemetry: element types ===\n");
+    fprintf(out, "%-32s %10s %10s %14s %14s %12s %14s\n",
+        "type", "allocs", "reallocs", "bytes alloc", "bytes moved", "peak cap", "slack bytes");
+
+    for (const auto& [name, s] : types)
+    {
+        fprintf(out, "%-32s %10llu %10llu %14llu %14llu %12llu %14llu\n",
+            name.c_str(),
+            (unsigned long long)s.numAllocs,
+            (unsigned long long)s.numReallocs,
+            (unsigned long long)s.bytesAllocated,
+            (unsigned long long)s.bytesMoved,
+            (unsigned long long)s.peakCapacity,
+            (unsigned long long)s.slackBytes);
+    }
+
+    const std::vector<site_stats> sites = get_site_stats();
+
+    fprintf(out, "\n=== cvector telemetry: call sites (by reallocations) ===\n");
+
+    for (size_t i = 0; i < std::min(maxSites, sites.size()); ++i)
+    {
+        const site_stats& site = sites[i];
+
+        fprintf(out, "%10llu reallocs %14llu bytes moved %12llu peak cap %14llu slack bytes  [%s]  %s:%u  %s\n",
+            (unsigned long long)site.stats.numReallocs,
+            (unsigned long long)site.stats.bytesMoved,
+            (unsigned long long)site.stats.peakCapacity,
+            (unsigned long long)site.stats.slackBytes,
+            site.typeName.c_str(),
+            site.file.c_str(),
+            site.line,
+            site.func.c_str());
+    }
+}
+
+#else
+
+// =================================================================================
+// TELEMETRY IS OFF
+//
+// nothing is recorded: cvector doesn't call the hooks (see ENABLE_TELEMETRY)
+// and the public API returns empty stats
+// =================================================================================
+template <typename T>
+inline void on_alloc(const call_site&, const ptrdiff_t, const ptrdiff_t, const ptrdiff_t) {}
+
+template <typename T>
+inline void on_release(const call_site&, const ptrdiff_t, const ptrdiff_t) {}
+
+inline realloc_hook set_realloc_hook(const realloc_hook) { return nullptr; }
+
+template <typename T>
+inline alloc_stats get_type_stats() { return {}; }
+
+inline void reset() {}
+
+inline void dump_report(FILE* out = stdout, const size_t = 20)
+{
+    if (out)
+        fprintf(out, "cvector telemetry is off (define CVECTOR_ENABLE_TELEMETRY=1)\n");
+}
+
+#endif // CVECTOR_ENABLE_TELEMETRY
+
+} // namespace cvector_telemetry
@@ -0,0 +1,366 @@
+// =================================================================================
+// Filename:     cvector_view.h
+// Description:  read-only zero-copy view of a file which was written with
+//               cvector::save(): the file is memory-mapped and its elements
+//               are used right in place (pages are loaded by the OS on demand),
+//               so there is no deserialization step at all;
+//
+//               the view has the read-only API of cvector: iteration, find,
+//               has_value, get_idx, binary_search, get_idxs, get_data_by_idxs
+//
+//               usage:
+//                   ids.save("scene_ids.bin");
+//                   ...
+//                   cvector_view<EntityID> ids("scene_ids.bin");
+//                   ids.get_idxs(queries, outIdxs);
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+template <typename T>
+class cvector_view
+{
+    static_assert(std::is_trivially_copyable_v<T>, "cvector_view: elements must be trivially copyable");
+
+public:
+    cvector_view() {}
+    explicit cvector_view(const char* path, const bool verifyChecksum = false) { open(path, verifyChecksum); }
+    ~cvector_view() { close(); }
+
+    cvector_view(const cvector_view&) = delete;
+    cvector_view& operator=(const cvector_view&) = delete;
+
+    cvector_view(cvector_view&& other) noexcept { *this = std::move(other); }
+    cvector_view& operator=(cvector_view&& rhs) noexcept;
+
+    // map a file into memory (the previous one is unmapped);
+    // the checksum is verified only if asked: it touches all the pages
+    bool open(const char* path, const bool verifyChecksum = false);
+    void close();
+    bool verify_checksum() const;
+
+    // getters
+    inline const T& operator[](index i)       const { return data_[i]; }
+
+    inline const T* begin()                   const { return data_; }
+    inline const T* end()                     const { return data_ + size_; }
+    inline const T* data()                    const { return data_; }
+    inline bool     is_open()                 const { return mapAddr_ != nullptr; }
+    inline bool     empty()                   const { return size_ == 0; }
+    inline vsize    size()                    const { return size_; }
+    inline bool     is_valid_index(index i)   const { return (i >= 0) && (i < size_); }
+
+    // search in random data
+    index find(const T& value) const;
+    bool  has_value(const T& value) const { return find(value) != -1; }
+
+    // search in sorted data (the same semantic as cvector)
+    index get_idx(const T& value) const;
+    bool  binary_search(const T& value) const;
+
+    template <typename IdxAlloc>
+    void get_idxs(
+        const T* values,
+        const vsize numValues,
+        cvector<index, IdxAlloc>& outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    template <typename Alloc, typename Growth, typename IdxAlloc>
+    void get_idxs(
+        const cvector<T, Alloc, Growth>& values,
+        cvector<index, IdxAlloc>& outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    // get elements by indices
+    template <typename IdxAlloc, typename OutAlloc>
+    void get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, cvector<T, OutAlloc>& outData) const;
+
+    template <typename IdxAlloc>
+    void get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, T* outData) const;
+
+private:
+    // cvector's search/gather helpers
+    using vec_type = cvector<T>;
+
+    const T*    data_     = nullptr;
+    vsize       size_     = 0;
+    uint64_t    checksum_ = 0;
+
+    void*       mapAddr_  = nullptr;
+    size_t      mapSize_  = 0;
+};
+
+
+// =================================================================================
+//                              open / close
+// =================================================================================
+template <typename T>
+cvector_view<T>& cvector_view<T>::operator=(cvector_view&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        close();
+
+        data_     = std::exchange(rhs.data_, nullptr);
+        size_     = std::exchange(rhs.size_, 0);
+        checksum_ = std::exchange(rhs.checksum_, 0);
+        mapAddr_  = std::exchange(rhs.mapAddr_, nullptr);
+        mapSize_  = std::exchange(rhs.mapSize_, 0);
+    }
+
+    return *this;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+bool cvector_view<T>::open(const char* path, const bool verifyChecksum)
+{
+    close();
+
+    if (path == nullptr)
+    {
+        cvector_io::print_error("cvector_view::open()", "invalid input args");
+        return false;
+    }
+
+    // map the whole file read-only
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        cvector_io::print_error(path, "can't open the file for reading");
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || ((uint64_t)fileSize.QuadPart < sizeof(cvector_io::file_header)))
+    {
+        CloseHandle(file);
+        cvector_io::print_error(path, "the file is truncated");
+        return false;
+    }
+
+    // the view keeps the mapping alive so both handles can be closed right away
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void*  addr    = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+    if (mapping)
+        CloseHandle(mapping);
+    CloseHandle(file);
+
+    const uint64_t size = (uint64_t)fileSize.QuadPart;
+#else
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        cvector_io::print_error(path, "can't open the file for reading");
+        return false;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || ((uint64_t)st.st_size < sizeof(cvector_io::file_header)))
+    {
+        ::close(fd);
+        cvector_io::print_error(path, "the file is truncated");
+        return false;
+    }
+
+    // the mapping stays valid after the file is closed
+    void* addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (addr == MAP_FAILED)
+        addr = nullptr;
+
+    const uint64_t size = (uint64_t)st.st_size;
+#endif
+
+    if (!addr)
+    {
+        cvector_io::print_error(path, "can't map the file into memory");
+        return false;
+    }
+
+    mapAddr_ = addr;
+    mapSize_ = (size_t)size;
+
+    // check the header
+    cvector_io::file_header header;
+    memcpy(&header, mapAddr_, sizeof(header));
+
+    if (const char* errMsg = cvector_io::check_header<T>(header, size))
+    {
+        close();
+        cvector_io::print_error(path, errMsg);
+        return false;
+    }
+
+    data_     = (const T*)((const char*)mapAddr_ + header.dataOffset);
+    size_     = (vsize)header.count;
+    checksum_ = header.checksum;
+
+    if (verifyChecksum && !verify_checksum())
+    {
+        close();
+        cvector_io::print_error(path, "checksum mismatch: the file is corrupted");
+        return false;
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+void cvector_view<T>::close()
+{
+    if (mapAddr_)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(mapAddr_);
+#else
+        munmap(mapAddr_, mapSize_);
+#endif
+    }
+
+    data_     = nullptr;
+    size_     = 0;
+    checksum_ = 0;
+    mapAddr_  = nullptr;
+    mapSize_  = 0;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+bool cvector_view<T>::verify_checksum() const
+{
+    return is_open() && (cvector_io::checksum(data_, size_ * sizeof(T)) == checksum_);
+}
+
+
+// =================================================================================
+//                                  search
+// =================================================================================
+template <typename T>
+index cvector_view<T>::find(const T& value) const
+{
+    // find the first matching value and return its index (or -1)
+
+    if constexpr (cvector_simd::is_searchable_v<T>)
+    {
+        return cvector_simd::find(data_, size_, value);
+    }
+    else
+    {
+        const T* it = std::find(begin(), end(), value);
+        return (it != end()) ? (index)(it - begin()) : -1;
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+index cvector_view<T>::get_idx(const T& value) const
+{
+    // NOTE: the data must be SORTED!
+    return vec_type::upper_bound_ptr(begin(), end(), value) - begin() - 1;
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+bool cvector_view<T>::binary_search(const T& value) const
+{
+    // NOTE: the data must be SORTED!
+    return vec_type::binary_search_ptr(begin(), end(), value);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+template <typename IdxAlloc>
+void cvector_view<T>::get_idxs(
+    const T* values,
+    const vsize numValues,
+    cvector<index, IdxAlloc>& outIdxs,
+    const query_order order) const
+{
+    // NOTE: the data must be SORTED!
+    // out: lower bound idx for each input value (see cvector::get_idxs())
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((values == nullptr) | (numValues < 0))
+        {
+            cvector_io::print_error("cvector_view::get_idxs()", "invalid input args");
+            return;
+        }
+    }
+
+    outIdxs.resize(numValues);
+    vec_type::template get_bound_idxs<false>(begin(), end(), values, numValues, outIdxs.begin(), order);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+template <typename Alloc, typename Growth, typename IdxAlloc>
+void cvector_view<T>::get_idxs(
+    const cvector<T, Alloc, Growth>& values,
+    cvector<index, IdxAlloc>& outIdxs,
+    const query_order order) const
+{
+    outIdxs.resize(values.size());
+    vec_type::template get_bound_idxs<false>(begin(), end(), values.data(), values.size(), outIdxs.begin(), order);
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+template <typename IdxAlloc, typename OutAlloc>
+void cvector_view<T>::get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, cvector<T, OutAlloc>& outData) const
+{
+    // out: elements by input indices (idxs must be valid)
+
+    outData.resize_default_init(idxs.size());
+    vec_type::gather_idxs(data_, idxs.data(), idxs.size(), outData.begin());
+}
+
+// ----------------------------------------------------
+
+template <typename T>
+template <typename IdxAlloc>
+void cvector_view<T>::get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, T* outData) const
+{
+    // NOTE: outData must have space for idxs.size() elements
+
+    if constexpr (ENABLE_CHECK)
+    {
+        if ((outData == nullptr) && !idxs.empty())
+        {
+            cvector_io::print_error("cvector_view::get_data_by_idxs()", "invalid input args");
+            return;
+        }
+    }
+
+    vec_type::gather_idxs(data_, idxs.data(), idxs.size(), outData);
+}
@@ -0,0 +1,128 @@
+// =================================================================================
+// Filename:     frozen_cvector.h
+// Description:  read-only table in static storage which is built at compile
+//               time with a constexpr cvector (construction, push_back, sorting)
+//               and then is queried with the same search API as cvector
+//               (get_idx, get_insert_idx, binary_search, find, has_value);
+//
+//               the memory of a cvector can't leave constant evaluation so
+//               the builder is called twice: to get the size and to copy
+//               the elements into the frozen table;
+//
+//               NOTE: elements must be literal types (for strings use
+//                     std::string_view, std::string can't be frozen)
+//
+//               usage:
+//                   constexpr cvector<int> MakeMaterialIds()
+//                   {
+//                       cvector<int> ids{ 40, 10, 30 };
+//                       ids.push_back(20);
+//                       std::sort(ids.begin(), ids.end());
+//                       return ids;
+//                   }
+//
+//                   static constexpr auto materialIds = cvector_freeze<MakeMaterialIds>();
+//                   const index i = materialIds.get_idx(30);     // 2
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+#include <array>
+
+
+template <typename T, vsize N>
+class frozen_cvector
+{
+    static_assert(N >= 0, "frozen_cvector: size must be >= 0");
+
+public:
+    constexpr frozen_cvector() = default;
+    constexpr explicit frozen_cvector(const T* src) { std::copy_n(src, N, data_.begin()); }
+
+    // getters
+    constexpr const T& operator[](index i) const { return data_[i]; }
+
+    constexpr const T* begin()              const { return data_.data(); }
+    constexpr const T* end()                const { return data_.data() + N; }
+    constexpr const T* data()               const { return data_.data(); }
+    constexpr bool     empty()              const { return N == 0; }
+    constexpr vsize    size()               const { return N; }
+    constexpr bool     is_valid_index(index i) const { return (i >= 0) && (i < N); }
+
+    // search in random data
+    constexpr index find(const T& value) const;
+    constexpr bool  has_value(const T& value) const { return find(value) != -1; }
+
+    // search in sorted data (the same semantic as cvector)
+    constexpr index get_idx(const T& value) const;
+    constexpr index get_insert_idx(const T& value) const;
+    constexpr bool  binary_search(const T& value) const;
+
+private:
+    // cvector's search helpers: branchless at runtime, std algorithms at compile time
+    using vec_type = cvector<T>;
+
+    std::array<T, N> data_{};
+};
+
+
+// =================================================================================
+// build a frozen table at compile time: Builder is a constexpr function
+// (or a lambda without captures) which returns a cvector
+// =================================================================================
+template <auto Builder>
+consteval auto cvector_freeze()
+{
+    using T = std::remove_cvref_t<decltype(Builder()[0])>;
+
+    constexpr vsize numElems = Builder().size();
+    const auto      vec      = Builder();
+
+    return frozen_cvector<T, numElems>(vec.data());
+}
+
+
+// =================================================================================
+//                                  search
+// =================================================================================
+template <typename T, vsize N>
+constexpr index frozen_cvector<T, N>::find(const T& value) const
+{
+    // find the first matching value and return its index (or -1)
+
+    if constexpr (cvector_simd::is_searchable_v<T>)
+    {
+        if (!std::is_constant_evaluated())
+            return cvector_simd::find(data(), N, value);
+    }
+
+    const T* it = std::find(begin(), end(), value);
+    return (it != end()) ? (index)(it - begin()) : -1;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N>
+constexpr index frozen_cvector<T, N>::get_idx(const T& value) const
+{
+    // NOTE: the table must be SORTED!
+    return vec_type::upper_bound_ptr(begin(), end(), value) - begin() - 1;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N>
+constexpr index frozen_cvector<T, N>::get_insert_idx(const T& value) const
+{
+    // position for sorted insertion (after all the equal values)
+    return vec_type::upper_bound_ptr(begin(), end(), value) - begin();
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N>
+constexpr bool frozen_cvector<T, N>::binary_search(const T& value) const
+{
+    // NOTE: the table must be SORTED!
+    return vec_type::binary_search_ptr(begin(), end(), value);
+}
@@ -0,0 +1,561 @@
+// =================================================================================
+// Filename:     segmented_cvector.h
+// Description:  vector for very large arrays which is stored in chunks of the same
+//               power-of-two size: growth allocates a new chunk and never copies
+//               the elements (so the peak memory is the size of data + one chunk
+//               instead of old + new buffers, and addresses of elements are stable);
+//
+//               an index is mapped to its chunk with a shift and a mask;
+//               chunks are contiguous so the hot loops are written per chunk
+//               (for_each_chunk, chunk(k)) and vectorized as usual;
+//
+//               it has the search/gather API of cvector: find, has_value, get_idx,
+//               get_insert_idx(s), get_idxs, binary_search, get_data_by_idxs
+//
+//               usage:
+//                   segmented_cvector<Voxel> voxels;           // 64K elements per chunk
+//                   voxels.reserve(numVoxels);
+//                   voxels.for_each_chunk([](Voxel* data, vsize count) { ... });
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+#include "cvector_span.h"
+
+
+template <typename T, int ChunkShift = 16, typename Alloc = std::allocator<T>>
+class segmented_cvector
+{
+    static_assert((ChunkShift >= 0) && (ChunkShift < 48), "segmented_cvector: invalid chunk size");
+
+public:
+    using allocator_type = Alloc;
+
+    static constexpr vsize chunkSize = vsize(1) << ChunkShift;     // elements per chunk
+    static constexpr vsize chunkMask = chunkSize - 1;
+
+    segmented_cvector() {}
+    explicit segmented_cvector(const Alloc& alloc) : alloc_(alloc) {}
+    segmented_cvector(const vsize count, const T& value = T(), const Alloc& alloc = Alloc());
+    ~segmented_cvector() { purge(); }
+
+    segmented_cvector(const segmented_cvector&) = delete;
+    segmented_cvector& operator=(const segmented_cvector&) = delete;
+
+    segmented_cvector(segmented_cvector&& other) noexcept;
+    segmented_cvector& operator=(segmented_cvector&& rhs) noexcept;
+
+
+    // getters
+    inline T&       operator[](const index i)       { return chunks_[i >> ChunkShift][i & chunkMask]; }
+    inline const T& operator[](const index i) const { return chunks_[i >> ChunkShift][i & chunkMask]; }
+
+    inline bool     empty()                 const { return size_ == 0; }
+    inline vsize    size()                  const { return size_; }
+    inline vsize    capacity()              const { return chunks_.size() * chunkSize; }
+    inline bool     is_valid_index(index i) const { return (i >= 0) && (i < size_); }
+
+    // chunks which contain elements (the last one can be partially filled)
+    inline vsize                 num_chunks()            const { return (size_ + chunkMask) >> ChunkShift; }
+    inline cvector_span<T>       chunk(const index k)          { return { chunks_[k], chunk_count(k) }; }
+    inline cvector_span<const T> chunk(const index k)    const { return { chunks_[k], chunk_count(k) }; }
+
+    // call func(T* data, vsize count) for each chunk in order
+    template <typename Func> void for_each_chunk(Func&& func);
+    template <typename Func> void for_each_chunk(Func&& func) const;
+
+    template <typename IdxAlloc, typename OutAlloc>
+    void get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, cvector<T, OutAlloc>& outData) const;
+
+    template <typename IdxAlloc>
+    void get_data_by_idxs(const cvector<index, IdxAlloc>& idxs, T* outData) const;
+
+
+    // setters
+    void push_back(const T& value);
+    void pop_back();
+    void clear();
+
+
+    // search in random data
+    index find(const T& value) const;
+    bool  has_value(const T& value) const { return find(value) != -1; }
+
+    // search in sorted data (the same semantic as cvector)
+    index get_idx(const T& value) const        { return bound_idx<true>(value) - 1; }
+    index get_insert_idx(const T& value) const { return bound_idx<true>(value); }
+    bool  binary_search(const T& value) const;
+
+    template <typename IdxAlloc>
+    void get_idxs(
+        const T* values,
+        const vsize numValues,
+        cvector<index, IdxAlloc>& outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    template <typename IdxAlloc>
+    void get_insert_idxs(
+        const T* values,
+        const vsize numValues,
+        cvector<index, IdxAlloc>& outIdxs,
+        const query_order order = query_order::unknown) const;
+
+    bool binary_search(const T* values, const vsize numValues) const;
+
+    template <typename FlagAlloc>
+    void binary_search(
+        const T* values,
+        const vsize numValues,
+        cvector<bool, FlagAlloc>& flags,
+        const query_order order = query_order::unknown) const;
+
+
+    // allocators: capacity is changed by whole chunks, elements are never moved
+    void reserve(const vsize newCapacity);
+    void resize(const vsize newSize);
+    void resize(const vsize newSize, const T& value);
+    void shrink_to_fit();
+    void purge();
+
+private:
+    using vec_type     = cvector<T>;
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    inline vsize chunk_count(const index k) const { return std::min(chunkSize, size_ - k * chunkSize); }
+
+    // call func(T* first, T* last) for each part of the index range [first, last) in a chunk
+    template <typename Func>
+    void for_each_range(const index first, const index last, Func&& func);
+
+    // lower (or upper) bound idx of the value in the whole SORTED array
+    template <bool IsUpper>
+    index bound_idx(const T& value) const;
+
+    template <bool IsUpper>
+    void get_bound_idxs(const T* values, const vsize numValues, index* outIdxs, const query_order order) const;
+
+    // is the bound of the value after the chunk k (so the chunk can be skipped)
+    template <bool IsUpper>
+    inline bool is_bound_after(const index k, const T& value) const
+    {
+        const T& last = chunks_[k][chunk_count(k) - 1];
+        return IsUpper ? !(value < last) : (last < value);
+    }
+
+    cvector<T*> chunks_;
+    vsize       size_ = 0;
+
+    [[no_unique_address]] Alloc alloc_;
+};
+
+
+// =================================================================================
+//                       constructor, destructor, move
+// =================================================================================
+template <typename T, int ChunkShift, typename Alloc>
+segmented_cvector<T, ChunkShift, Alloc>::segmented_cvector(const vsize count, const T& value, const Alloc& alloc) :
+    alloc_(alloc)
+{
+    resize(count, value);
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+segmented_cvector<T, ChunkShift, Alloc>::segmented_cvector(segmented_cvector&& other) noexcept :
+    chunks_(std::move(other.chunks_)),
+    size_(std::exchange(other.size_, 0)),
+    alloc_(other.alloc_)
+{
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+segmented_cvector<T, ChunkShift, Alloc>& segmented_cvector<T, ChunkShift, Alloc>::operator=(segmented_cvector&& rhs) noexcept
+{
+    if (this == &rhs) return *this;
+
+    purge();
+
+    chunks_ = std::move(rhs.chunks_);
+    size_   = std::exchange(rhs.size_, 0);
+    alloc_  = rhs.alloc_;
+
+    return *this;
+}
+
+
+// =================================================================================
+//                                  getters
+// =================================================================================
+template <typename T, int ChunkShift, typename Alloc>
+template <typename Func>
+void segmented_cvector<T, ChunkShift, Alloc>::for_each_chunk(Func&& func)
+{
+    for (index k = 0; k < num_chunks(); ++k)
+        func(chunks_[k], chunk_count(k));
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+template <typename Func>
+void segmented_cvector<T, ChunkShift, Alloc>::for_each_chunk(Func&& func) const
+{
+    for (index k = 0; k < num_chunks(); ++k)
+        func((const T*)chunks_[k], chunk_count(k));
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+template <typename IdxAlloc, typename OutAlloc>
+void segmented_cvector<T, ChunkShift, Alloc>::get_data_by_idxs(
+    const cvector<index, IdxAlloc>& idxs,
+    cvector<T, OutAlloc>& outData) const
+{
+    outData.resize(idxs.size());
+    get_data_by_idxs(idxs, outData.begin());
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+template <typename IdxAlloc>
+void segmented_cvector<T, ChunkShift, Alloc>::get_data_by_idxs(
+    const cvector<index, IdxAlloc>& idxs,
+    T* outData) const
+{
+    // NOTE: idxs must be valid
+    // DESC: out[i] = (*this)[idxs[i]], the source elements are prefetched ahead
+    //       (a chunk lookup costs a shift and a mask)
+
+    constexpr vsize dist = CVECTOR_GATHER_PREFETCH_DISTANCE;
+
+    const index* pIdxs   = idxs.data();
+    const vsize  numIdxs = idxs.size();
+
+    for (index i = 0; i < numIdxs; ++i)
+    {
+        if (i + dist < numIdxs)
+            cvector_simd::prefetch_elem(&(*this)[pIdxs[i + dist]]);
+
+        outData[i] = (*this)[pIdxs[i]];
+    }
+}
+
+
+// =================================================================================
+//                                  setters
+// =================================================================================
+template <typename T, int ChunkShift, typename Alloc>
+void segmented_cvector<T, ChunkShift, Alloc>::push_back(const T& value)
+{
+    // only a new chunk is allocated: the elements are never copied
+    if (size_ == capacity())
+        chunks_.push_back(alloc_traits::allocate(alloc_, (size_t)chunkSize));
+
+    new (&(*this)[size_]) T(value);
+    size_++;
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+inline void segmented_cvector<T, ChunkShift, Alloc>::pop_back()
+{
+    if (size_ > 0)
+        std::destroy_at(&(*this)[--size_]);
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+inline void segmented_cvector<T, ChunkShift, Alloc>::clear()
+{
+    // destroy all the elements but keep the chunks
+    resize(0);
+}
+
+
+// =================================================================================
+//                              search (random data)
+// =================================================================================
+template <typename T, int ChunkShift, typename Alloc>
+index segmented_cvector<T, ChunkShift, Alloc>::find(const T& value) const
+{
+    // find the first matching value chunk by chunk (SIMD within a chunk)
+
+    for (index k = 0; k < num_chunks(); ++k)
+    {
+        const index idx = chunk(k).find(value);
+
+        if (idx != -1)
+            return k * chunkSize + idx;
+    }
+
+    return -1;
+}
+
+
+// =================================================================================
+//                              search (sorted data)
+// =================================================================================
+template <typename T, int ChunkShift, typename Alloc>
+template <bool IsUpper>
+index segmented_cvector<T, ChunkShift, Alloc>::bound_idx(const T& value) const
+{
+    // NOTE: elements must be SORTED!
+    // binary search of the chunk by its last element, then -- within the chunk
+
+    index lo = 0;
+    index hi = num_chunks();
+
+    while (lo < hi)
+    {
+        const index mid = (lo + hi) / 2;
+
+        if (is_bound_after<IsUpper>(mid, value))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == num_chunks())
+        return size_;
+
+    const T* b = chunks_[lo];
+    const T* e = b + chunk_count(lo);
+    const T* it = IsUpper ? vec_type::upper_bound_ptr(b, e, value) : vec_type::lower_bound_ptr(b, e, value);
+
+    return lo * chunkSize + (it - b);
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+template <bool IsUpper>
+void segmented_cvector<T, ChunkShift, Alloc>::get_bound_idxs(
+    const T* values,
+    const vsize numValues,
+    index* outIdxs,
+    const query_order order) const
+{
+    if (!vec_type::is_sorted_batch(values, numValues, order))
+    {
+        for (index i = 0; i < numValues; ++i)
+            outIdxs[i] = bound_idx<IsUpper>(values[i]);
+        return;
+    }
+
+    // sorted queries: bounds don't decrease so move through the chunks once
+    // and gallop within a chunk from the previous bound
+    const vsize numChunks = num_chunks();
+    index       k         = 0;
+    const T*    it        = (numChunks > 0) ? chunks_[0] : nullptr;
+
+    for (index i = 0; i < numValues; ++i)
+    {
+        while ((k < numChunks) && is_bound_after<IsUpper>(k, values[i]))
+        {
+            if (++k < numChunks)
+                it = chunks_[k];
+        }
+
+        if (k == numChunks)
+        {
+            outIdxs[i] = size_;
+            continue;
+        }
+
+        it = vec_type::template gallop_bound_ptr<IsUpper>(it, chunks_[k] + chunk_count(k), values[i]);
+        outIdxs[i] = k * chunkSize + (it - chunks_[k]);
+    }
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+bool segmented_cvector<T, ChunkShift, Alloc>::binary_search(const T& value) const
+{
+    const index idx = bound_idx<false>(value);
+    return (idx < size_) && !(value < (*this)[idx]);
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+template <typename IdxAlloc>
+void segmented_cvector<T, ChunkShift, Alloc>::get_idxs(
+    const T* values,
+    const vsize numValues,
+    cvector<index, IdxAlloc>& outIdxs,
+    const query_order order) const
+{
+    // NOTE: elements must be SORTED!
+    // out: lower bound idx for each input value
+
+    outIdxs.resize(numValues);
+    get_bound_idxs<false>(values, numValues, outIdxs.begin(), order);
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+template <typename IdxAlloc>
+void segmented_cvector<T, ChunkShift, Alloc>::get_insert_idxs(
+    const T* values,
+    const vsize numValues,
+    cvector<index, IdxAlloc>& outIdxs,
+    const query_order order) const
+{
+    // NOTE: elements must be SORTED!
+    // out: position for sorted insertion of each input value
+
+    outIdxs.resize(numValues);
+    get_bound_idxs<true>(values, numValues, outIdxs.begin(), order);
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+bool segmented_cvector<T, ChunkShift, Alloc>::binary_search(const T* values, const vsize numValues) const
+{
+    // check if all the input values exist (value i is searched in range [i, size)
+    // as cvector::binary_search() does)
+
+    bool isExist = true;
+
+    for (index i = 0; i < numValues; ++i)
+    {
+        const index pos = std::max(bound_idx<false>(values[i]), i);
+        isExist &= (pos < size_) && !(values[i] < (*this)[pos]);
+    }
+
+    return isExist;
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+template <typename FlagAlloc>
+void segmented_cvector<T, ChunkShift, Alloc>::binary_search(
+    const T* values,
+    const vsize numValues,
+    cvector<bool, FlagAlloc>& flags,
+    const query_order order) const
+{
+    // out: existence flag for each input value (value i is searched in range [i, size)
+    // as cvector::binary_search() does)
+
+    cvector<index> idxs;
+    get_idxs(values, numValues, idxs, order);
+
+    flags.resize(numValues);
+
+    for (index i = 0; i < numValues; ++i)
+    {
+        const index pos = std::max(idxs[i], i);
+        flags[i] = (pos < size_) && !(values[i] < (*this)[pos]);
+    }
+}
+
+
+// =================================================================================
+//                          change size / capacity
+// =================================================================================
+template <typename T, int ChunkShift, typename Alloc>
+void segmented_cvector<T, ChunkShift, Alloc>::reserve(const vsize newCapacity)
+{
+    // allocate the missing chunks (only the table of chunk pointers is reallocated)
+
+    const vsize numChunks = (newCapacity + chunkMask) >> ChunkShift;
+
+    if (chunks_.size() >= numChunks)
+        return;
+
+    chunks_.reserve(numChunks);
+
+    while (chunks_.size() < numChunks)
+        chunks_.push_back(alloc_traits::allocate(alloc_, (size_t)chunkSize));
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+void segmented_cvector<T, ChunkShift, Alloc>::resize(const vsize newSize)
+{
+    // new elements (if any) are value-initialized: T()
+
+    const vsize sz = newSize * (newSize >= 0);
+    reserve(sz);
+
+    if (size_ < sz)
+        for_each_range(size_, sz, [](T* first, T* last) { std::uninitialized_value_construct(first, last); });
+    else
+        for_each_range(sz, size_, [](T* first, T* last) { std::destroy(first, last); });
+
+    size_ = sz;
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+void segmented_cvector<T, ChunkShift, Alloc>::resize(const vsize newSize, const T& value)
+{
+    // new elements (if any) are copies of the input value
+
+    const vsize sz = newSize * (newSize >= 0);
+    reserve(sz);
+
+    if (size_ < sz)
+        for_each_range(size_, sz, [&value](T* first, T* last) { std::uninitialized_fill(first, last, value); });
+    else
+        for_each_range(sz, size_, [](T* first, T* last) { std::destroy(first, last); });
+
+    size_ = sz;
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+void segmented_cvector<T, ChunkShift, Alloc>::shrink_to_fit()
+{
+    // release the chunks which don't contain any elements
+
+    while (chunks_.size() > num_chunks())
+    {
+        alloc_traits::deallocate(alloc_, chunks_[chunks_.size() - 1], (size_t)chunkSize);
+        chunks_.pop_back();
+    }
+
+    chunks_.shrink_to_fit();
+}
+
+// ----------------------------------------------------
+
+template <typename T, int ChunkShift, typename Alloc>
+void segmented_cvector<T, ChunkShift, Alloc>::purge()
+{
+    // destroy all the elements and release all the chunks
+    clear();
+    shrink_to_fit();
+}
+
+
+// =================================================================================
+//                              private methods
+// =================================================================================
+template <typename T, int ChunkShift, typename Alloc>
+template <typename Func>
+void segmented_cvector<T, ChunkShift, Alloc>::for_each_range(const index first, const index last, Func&& func)
+{
+    for (index i = first; i < last; )
+    {
+        const index end = std::min(last, (i | chunkMask) + 1);     // the end of the chunk
+
+        func(&(*this)[i], &(*this)[i] + (end - i));
+        i = end;
+    }
+}
@@ -0,0 +1,294 @@
+// =================================================================================
+// Filename:     small_cvector.h
+// Description:  small-buffer-optimized cvector: keeps up to N elements
+//               inline (right inside the object) and only spills into
+//               the heap when it grows beyond that;
+//
+//               small_cvector<T, N> is derived from cvector so it has the same
+//               API (push_back, insert_before, get_idx, get_idxs, binary_search, etc.)
+// =================================================================================
+#pragma once
+
+#include "cvector.h"
+
+
+// =================================================================================
+// SMALL BUFFER ALLOCATOR
+//
+// gives out the inline buffer if it is big enough and isn't in use yet,
+// otherwise the memory is allocated by the Upstream allocator
+// =================================================================================
+template <typename T, vsize N, typename Upstream = std::allocator<T>>
+class small_buffer_allocator
+{
+public:
+    using value_type = T;
+
+    // each container has its own inline buffer so never share allocators
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap            = std::false_type;
+    using is_always_equal                        = std::false_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = small_buffer_allocator<U, N, typename std::allocator_traits<Upstream>::template rebind_alloc<U>>;
+    };
+
+    // inline memory which is owned by the container
+    struct storage
+    {
+        alignas(T) unsigned char buf[N * sizeof(T)];
+        bool inUse = false;
+    };
+
+
+    small_buffer_allocator(storage* pStorage, const Upstream& upstream = Upstream()) :
+        storage_(pStorage),
+        upstream_(upstream)
+    {
+    }
+
+    T* allocate(const size_t n)
+    {
+        if ((n <= (size_t)N) && !storage_->inUse)
+        {
+            storage_->inUse = true;
+            return (T*)storage_->buf;
+        }
+
+        return std::allocator_traits<Upstream>::allocate(upstream_, n);
+    }
+
+    void deallocate(T* ptr, const size_t n)
+    {
+        if (ptr == (T*)storage_->buf)
+        {
+            storage_->inUse = false;
+            return;
+        }
+
+        std::allocator_traits<Upstream>::deallocate(upstream_, ptr, n);
+    }
+
+    inline bool            is_inline(const T* ptr) const { return ptr == (const T*)storage_->buf; }
+    inline const Upstream& upstream()              const { return upstream_; }
+
+    bool operator==(const small_buffer_allocator& rhs) const
+    {
+        return (storage_ == rhs.storage_) && (upstream_ == rhs.upstream_);
+    }
+
+private:
+    storage* storage_ = nullptr;
+    [[no_unique_address]] Upstream upstream_;
+};
+
+
+// =================================================================================
+// SMALL CVECTOR
+// =================================================================================
+template <typename T, vsize N, typename Alloc = std::allocator<T>>
+class small_cvector : public cvector<T, small_buffer_allocator<T, N, Alloc>>
+{
+    static_assert(N > 0, "small_cvector: inline capacity must be > 0");
+
+public:
+    using alloc_type = small_buffer_allocator<T, N, Alloc>;
+    using base       = cvector<T, alloc_type>;
+
+    small_cvector();
+    explicit small_cvector(const Alloc& alloc);
+    small_cvector(const vsize count, const T& value = T(), const Alloc& alloc = Alloc());
+    small_cvector(std::initializer_list<T> il, const Alloc& alloc = Alloc());
+
+    template<typename Iter>
+    inline small_cvector(const Iter* first, const Iter* last, const Alloc& alloc = Alloc()) :
+        base(alloc_type(&storage_, alloc))
+    {
+        base::reserve(N);
+        base::assign(first, last);
+    }
+
+    small_cvector(const small_cvector& other);
+    small_cvector(small_cvector&& other) noexcept;
+
+    ~small_cvector();
+
+    small_cvector& operator=(const small_cvector& rhs);
+    small_cvector& operator=(small_cvector&& rhs) noexcept;
+    small_cvector& operator=(std::initializer_list<T> list);
+
+    // release the heap memory (if any) and return to the inline buffer
+    void purge();
+    void shrink_to_fit();
+
+    inline bool        is_inline()       const { return this->alloc_.is_inline(this->data_); }
+    static constexpr vsize inline_capacity()   { return N; }
+
+private:
+    void move_from(small_cvector&& other);
+
+    typename alloc_type::storage storage_;
+};
+
+
+// =================================================================================
+//                          constructor, destructor
+// =================================================================================
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>::small_cvector() :
+    base(alloc_type(&storage_))
+{
+    base::reserve(N);
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>::small_cvector(const Alloc& alloc) :
+    base(alloc_type(&storage_, alloc))
+{
+    base::reserve(N);
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>::small_cvector(const vsize count, const T& value, const Alloc& alloc) :
+    base(alloc_type(&storage_, alloc))
+{
+    base::reserve(N);
+    base::resize(count, value);
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>::small_cvector(std::initializer_list<T> il, const Alloc& alloc) :
+    base(alloc_type(&storage_, alloc))
+{
+    base::reserve(N);
+    base::assign(il.begin(), il.end());
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>::small_cvector(const small_cvector& other) :
+    base(alloc_type(&storage_, other.alloc_.upstream()))
+{
+    base::reserve(N);
+    base::assign(other.begin(), other.end());
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>::small_cvector(small_cvector&& other) noexcept :
+    base(alloc_type(&storage_, other.alloc_.upstream()))
+{
+    move_from(std::move(other));
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+small_cvector<T, N, Alloc>::~small_cvector()
+{
+    // release memory here while the inline storage is still alive
+    base::purge();
+}
+
+
+// =================================================================================
+//                  assignment: copy, move, initializer_list
+// =================================================================================
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>& small_cvector<T, N, Alloc>::operator=(const small_cvector& rhs)
+{
+    base::operator=(rhs);
+    return *this;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>& small_cvector<T, N, Alloc>::operator=(small_cvector&& rhs) noexcept
+{
+    if (this == &rhs) return *this;
+
+    base::purge();
+    move_from(std::move(rhs));
+
+    return *this;
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+inline small_cvector<T, N, Alloc>& small_cvector<T, N, Alloc>::operator=(std::initializer_list<T> list)
+{
+    base::operator=(list);
+    return *this;
+}
+
+
+// =================================================================================
+//                            memory deallocation
+// =================================================================================
+template <typename T, vsize N, typename Alloc>
+inline void small_cvector<T, N, Alloc>::purge()
+{
+    base::purge();
+    base::reserve(N);
+}
+
+// ----------------------------------------------------
+
+template <typename T, vsize N, typename Alloc>
+inline void small_cvector<T, N, Alloc>::shrink_to_fit()
+{
+    // if the elements fit into the inline buffer -- move them back there
+    // (the inline buffer is the minimal capacity, so it's never shrunk)
+
+    if (is_inline())
+        return;
+
+    if (this->size_ > N)
+    {
+        base::shrink_to_fit();
+        return;
+    }
+
+    base::realloc_buffer(N);
+}
+
+
+// =================================================================================
+//                              private methods
+// =================================================================================
+template <typename T, vsize N, typename Alloc>
+void small_cvector<T, N, Alloc>::move_from(small_cvector&& other)
+{
+    // NOTE: (*this) must be purged before the call
+
+    // elements are inline or the buffer belongs to another upstream allocator
+    // (it can't be freed through ours): move them one by one (or relocate if possible)
+    if (other.is_inline() || !other.data_ || !(this->alloc_.upstream() == other.alloc_.upstream()))
+    {
+        base::reserve(N);
+        base::append_vector(static_cast<base&&>(other));
+        other.reserve(N);
+        return;
+    }
+
+    // elements are in the heap: just steal the buffer
+    this->data_      = std::exchange(other.data_, nullptr);
+    this->size_      = std::exchange(other.size_, 0);
+    this->capacity_  = std::exchange(other.capacity_, 0);
+    this->allocSite_ = other.allocSite_;
+
+    other.reserve(N);
+}